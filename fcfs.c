@@ -0,0 +1,114 @@
+/*
+ * Implementation of the FCFS scheduling algorithm.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include "mydispatcher.h"
+
+/*
+ * Create the Ready state of FCFS, which is a plain queue in order of arrival.
+ *
+ * params:	a pointer to the parameters of the policy (unused)
+ * pool:	a pointer to the memory pool that owns the queue and its nodes
+ *
+ * Returns: a pointer to the queue
+ */
+static void* fcfs_create(const struct policy_params* params, struct arena* pool) {
+	return create_queue(pool);
+}
+
+/*
+ * Add a process that has arrived to the end of the ready queue.
+ *
+ * ready:	a pointer to the ready queue
+ * table:	a pointer to the table the process is in
+ * process:	the index of the process
+ * now:		the current time
+ */
+static void fcfs_add_ready(void* ready, const struct process_table* table, int process, long now) {
+	enqueue((struct queue*) ready, process);
+}
+
+/*
+ * Get the number of processes in the ready queue.
+ *
+ * ready:	a pointer to the ready queue
+ *
+ * Returns: the number of processes
+ */
+static int fcfs_num_ready(void* ready) {
+	return ((struct queue*) ready)->size;
+}
+
+/*
+ * Remove the process that arrived first from the ready queue.
+ *
+ * ready:	a pointer to the ready queue
+ * table:	a pointer to the table the processes are in
+ * now:		the current time
+ *
+ * Returns: the index of the process to be dispatched
+ */
+static int fcfs_select_next(void* ready, const struct process_table* table, long now) {
+	return dequeue((struct queue*) ready);
+}
+
+/*
+ * FCFS lets a dispatched process run until it completes, so its time slice is unlimited.
+ *
+ * Returns: 0
+ */
+static long fcfs_time_slice(void* ready, const struct process_table* table, int process) {
+	return 0;
+}
+
+/*
+ * FCFS is non-preemptive, so the running process is never preempted.
+ *
+ * Returns: 0
+ */
+static int fcfs_should_preempt(void* ready, const struct process_table* table, int running, int slice_expired, long now) {
+	return 0;
+}
+
+/*
+ * Never called, since FCFS never preempts the running process.
+ */
+static void fcfs_preempt(void* ready, const struct process_table* table, int process, int slice_expired, long now) {
+	fcfs_add_ready(ready, table, process, now);
+}
+
+/*
+ * Write the ready queue to a checkpoint.
+ *
+ * ready:			a pointer to the ready queue
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ */
+static void fcfs_save(void* ready, int running, FILE* checkpoint_file) {
+	save_queue((struct queue*) ready, checkpoint_file);
+}
+
+/*
+ * Read the ready queue written by fcfs_save() from a checkpoint into the empty ready queue.
+ *
+ * ready:			a pointer to the ready queue
+ * table:			a pointer to the table the processes are in
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ *
+ * Returns: 0 on success, -1 if the checkpoint is damaged
+ */
+static int fcfs_load(void* ready, const struct process_table* table, int running, FILE* checkpoint_file) {
+	return load_queue((struct queue*) ready, table, checkpoint_file);
+}
+
+/* The FCFS scheduling policy. */
+const struct policy fcfs_policy = {
+	"FCFS", 0, fcfs_create, fcfs_add_ready, fcfs_num_ready, fcfs_select_next, fcfs_time_slice, fcfs_should_preempt, fcfs_preempt, fcfs_save, fcfs_load, NULL
+};
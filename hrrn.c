@@ -0,0 +1,187 @@
+/*
+ * Implementation of the Highest Response Ratio Next (HRRN) scheduling algorithm.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include "mydispatcher.h"
+
+/* Representation of the Ready state of HRRN. Since the response ratio of every waiting process changes as
+ * time passes, there is no fixed order to keep, and the processes are simply kept in order of arrival. */
+struct hrrn_ready {
+	int* processes;				// the indices of the processes in the Ready state, in order of arrival
+	int size;					// the number of processes in the Ready state
+	int capacity;				// the number of processes the array can hold before it has to grow
+	struct arena* pool;			// the memory pool the array is taken from
+};
+
+/*
+ * Create the Ready state of HRRN.
+ *
+ * params:	a pointer to the parameters of the policy (unused)
+ * pool:	a pointer to the memory pool that owns the Ready state
+ *
+ * Returns: a pointer to the Ready state
+ */
+static void* hrrn_create(const struct policy_params* params, struct arena* pool) {
+	struct hrrn_ready* created_ready = (struct hrrn_ready*) arena_alloc(pool, sizeof(struct hrrn_ready));
+	created_ready->capacity = 16;
+	created_ready->processes = (int*) arena_alloc(pool, created_ready->capacity * sizeof(int));
+	created_ready->size = 0;
+	created_ready->pool = pool;
+	return created_ready;
+}
+
+/*
+ * Add a process that has arrived to the Ready state.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the process is in
+ * process:	the index of the process
+ * now:		the current time
+ */
+static void hrrn_add_ready(void* ready, const struct process_table* table, int process, long now) {
+	struct hrrn_ready* current_ready = (struct hrrn_ready*) ready;
+	if (current_ready->size == current_ready->capacity) {
+		/* If the array is full, double its capacity. */
+		size_t old_size = current_ready->capacity * sizeof(int);
+		current_ready->capacity *= 2;
+		current_ready->processes = (int*) arena_grow(current_ready->pool, current_ready->processes, old_size, current_ready->capacity * sizeof(int));
+	}
+	current_ready->processes[current_ready->size++] = process;
+}
+
+/*
+ * Get the number of processes in the Ready state.
+ *
+ * ready:	a pointer to the Ready state
+ *
+ * Returns: the number of processes
+ */
+static int hrrn_num_ready(void* ready) {
+	return ((struct hrrn_ready*) ready)->size;
+}
+
+/*
+ * Check whether one process has a strictly higher response ratio (W + S) / S than another at a specified
+ * time. A process with a service time of 0 has an infinitely high response ratio.
+ *
+ * table:	a pointer to the table the processes are in
+ * first:	the index of the first process
+ * second:	the index of the second process
+ * now:		the current time
+ *
+ * Returns: 1 if the first process has a higher response ratio than the second one, 0 otherwise
+ */
+static int higher_response_ratio(const struct process_table* table, int first, int second, long now) {
+	long first_service = table->service_time[first];
+	long second_service = table->service_time[second];
+	if (first_service == 0 || second_service == 0) {
+		return first_service == 0 && second_service != 0;
+	}
+
+	/* Compare the ratios by cross-multiplying, which is exact since the products of two 64-bit times are
+	 * worked out in 128 bits. */
+	__int128 first_response = now - table->arrival_time[first] + first_service;
+	__int128 second_response = now - table->arrival_time[second] + second_service;
+	return first_response * second_service > second_response * first_service;
+}
+
+/*
+ * Remove the process with the highest response ratio from the Ready state. Among processes with the same
+ * response ratio, the one that arrived first is chosen.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the processes are in
+ * now:		the current time
+ *
+ * Returns: the index of the process to be dispatched
+ */
+static int hrrn_select_next(void* ready, const struct process_table* table, long now) {
+	struct hrrn_ready* current_ready = (struct hrrn_ready*) ready;
+	int best = 0;
+	for (int i = 1; i < current_ready->size; i++) {
+		if (higher_response_ratio(table, current_ready->processes[i], current_ready->processes[best], now)) {
+			best = i;
+		}
+	}
+
+	/* Remove the chosen process while keeping the others in order of arrival. */
+	int process_to_return = current_ready->processes[best];
+	memmove(&current_ready->processes[best], &current_ready->processes[best+1], (current_ready->size - best - 1) * sizeof(int));
+	current_ready->size--;
+	return process_to_return;
+}
+
+/*
+ * HRRN lets a dispatched process run until it completes, so its time slice is unlimited.
+ *
+ * Returns: 0
+ */
+static long hrrn_time_slice(void* ready, const struct process_table* table, int process) {
+	return 0;
+}
+
+/*
+ * HRRN is non-preemptive, so the running process is never preempted.
+ *
+ * Returns: 0
+ */
+static int hrrn_should_preempt(void* ready, const struct process_table* table, int running, int slice_expired, long now) {
+	return 0;
+}
+
+/*
+ * Never called, since HRRN never preempts the running process.
+ */
+static void hrrn_preempt(void* ready, const struct process_table* table, int process, int slice_expired, long now) {
+	hrrn_add_ready(ready, table, process, now);
+}
+
+/*
+ * Write the processes of the Ready state, in order of arrival, to a checkpoint.
+ *
+ * ready:			a pointer to the Ready state
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ */
+static void hrrn_save(void* ready, int running, FILE* checkpoint_file) {
+	struct hrrn_ready* current_ready = (struct hrrn_ready*) ready;
+	fwrite(&current_ready->size, sizeof(int), 1, checkpoint_file);
+	fwrite(current_ready->processes, sizeof(int), current_ready->size, checkpoint_file);
+}
+
+/*
+ * Read the Ready state written by hrrn_save() from a checkpoint into the empty Ready state.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the processes are in
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ *
+ * Returns: 0 on success, -1 if the checkpoint is damaged
+ */
+static int hrrn_load(void* ready, const struct process_table* table, int running, FILE* checkpoint_file) {
+	int size;
+	if (fread(&size, sizeof(int), 1, checkpoint_file) != 1 || size < 0 || size > table->size) {
+		return -1;
+	}
+	for (int i = 0; i < size; i++) {
+		int process;
+		if (read_checkpoint_process(checkpoint_file, table, &process) != 0) {
+			return -1;
+		}
+		hrrn_add_ready(ready, table, process, 0);
+	}
+	return 0;
+}
+
+/* The HRRN scheduling policy. */
+const struct policy hrrn_policy = {
+	"HRRN", 0, hrrn_create, hrrn_add_ready, hrrn_num_ready, hrrn_select_next, hrrn_time_slice, hrrn_should_preempt, hrrn_preempt, hrrn_save, hrrn_load, NULL
+};
@@ -0,0 +1,243 @@
+/*
+ * Implementation of the multilevel feedback queue (MLFQ) scheduling algorithm.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include "mydispatcher.h"
+
+/* Representation of the Ready state of MLFQ. Level 0 has the highest priority, and the time quantum doubles
+ * with every level. */
+struct mlfq_ready {
+	struct queue** levels;		// one queue of processes per priority level
+	int num_levels;				// the number of priority levels
+	int size;					// the total number of processes in the Ready state
+	long quantum;				// the time quantum of level 0
+	long boost_interval;		// how often every process is moved back to level 0 (0 for never)
+	long next_boost;			// the time of the next priority boost
+	int* level;					// the current priority level of each row of the process table
+	int level_capacity;			// the number of rows the level array can hold before it has to grow
+	struct arena* pool;			// the memory pool the Ready state is taken from
+};
+
+/*
+ * Create the Ready state of MLFQ.
+ *
+ * params:	a pointer to the parameters of the policy, which give the number of levels, the time quantum of
+ *			level 0 and the priority boost interval
+ * pool:	a pointer to the memory pool that owns the Ready state
+ *
+ * Returns: a pointer to the Ready state
+ */
+static void* mlfq_create(const struct policy_params* params, struct arena* pool) {
+	struct mlfq_ready* created_ready = (struct mlfq_ready*) arena_alloc(pool, sizeof(struct mlfq_ready));
+	created_ready->num_levels = params->num_levels;
+	created_ready->levels = (struct queue**) arena_alloc(pool, params->num_levels * sizeof(struct queue*));
+	for (int i = 0; i < params->num_levels; i++) {
+		created_ready->levels[i] = create_queue(pool);
+	}
+	created_ready->size = 0;
+	created_ready->quantum = params->quantum;
+	created_ready->boost_interval = params->boost_interval;
+	created_ready->next_boost = params->boost_interval;
+	created_ready->level_capacity = 64;
+	created_ready->level = (int*) arena_alloc(pool, created_ready->level_capacity * sizeof(int));
+	created_ready->pool = pool;
+	return created_ready;
+}
+
+/*
+ * Add a process to the end of the queue of a specified level.
+ *
+ * current_ready:	a pointer to the Ready state
+ * process:			the index of the process
+ * level:			the priority level
+ */
+static void mlfq_enqueue(struct mlfq_ready* current_ready, int process, int level) {
+	current_ready->level[process] = level;
+	enqueue(current_ready->levels[level], process);
+	current_ready->size++;
+}
+
+/*
+ * Add a process that has arrived to the end of the queue of level 0.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the process is in
+ * process:	the index of the process
+ * now:		the current time
+ */
+static void mlfq_add_ready(void* ready, const struct process_table* table, int process, long now) {
+	struct mlfq_ready* current_ready = (struct mlfq_ready*) ready;
+	if (current_ready->level_capacity < table->capacity) {
+		/* If the process table has grown, grow the level array with it. */
+		current_ready->level = (int*) arena_grow(current_ready->pool, current_ready->level, current_ready->level_capacity * sizeof(int), table->capacity * sizeof(int));
+		current_ready->level_capacity = table->capacity;
+	}
+	mlfq_enqueue(current_ready, process, 0);
+}
+
+/*
+ * Get the number of processes in the Ready state.
+ *
+ * ready:	a pointer to the Ready state
+ *
+ * Returns: the number of processes
+ */
+static int mlfq_num_ready(void* ready) {
+	return ((struct mlfq_ready*) ready)->size;
+}
+
+/*
+ * Remove the process at the front of the highest non-empty level. If a priority boost is due, every process
+ * is first moved back to level 0, keeping the order of the levels.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the processes are in
+ * now:		the current time
+ *
+ * Returns: the index of the process to be dispatched
+ */
+static int mlfq_select_next(void* ready, const struct process_table* table, long now) {
+	struct mlfq_ready* current_ready = (struct mlfq_ready*) ready;
+	if (current_ready->boost_interval > 0 && now >= current_ready->next_boost) {
+		for (int i = 1; i < current_ready->num_levels; i++) {
+			while (current_ready->levels[i]->size > 0) {
+				int process = dequeue(current_ready->levels[i]);
+				current_ready->level[process] = 0;
+				enqueue(current_ready->levels[0], process);
+			}
+		}
+		/* A boost past the largest time a long holds never comes, since every process has finished by then. */
+		long num_boosts = now / current_ready->boost_interval + 1;
+		current_ready->next_boost = num_boosts <= LONG_MAX / current_ready->boost_interval ? num_boosts * current_ready->boost_interval : LONG_MAX;
+	}
+
+	for (int i = 0; i < current_ready->num_levels; i++) {
+		if (current_ready->levels[i]->size > 0) {
+			current_ready->size--;
+			return dequeue(current_ready->levels[i]);
+		}
+	}
+	return -1;
+}
+
+/*
+ * A dispatched process runs for at most the time quantum of its level, which is the time quantum of level 0
+ * doubled once per level. A time quantum too large to fit in a long could never run out, so it is unlimited.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the process is in
+ * process:	the index of the dispatched process
+ *
+ * Returns: the time quantum of the level of the process, or 0 if it is unlimited
+ */
+static long mlfq_time_slice(void* ready, const struct process_table* table, int process) {
+	struct mlfq_ready* current_ready = (struct mlfq_ready*) ready;
+	int level = current_ready->level[process];
+	if (current_ready->quantum > (LONG_MAX >> level)) {
+		return 0;
+	}
+	return current_ready->quantum << level;
+}
+
+/*
+ * Check whether the running process has to be preempted, which is the case when its time quantum has run
+ * out and some other process is ready. Otherwise, it simply gets another time quantum at the same level.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the processes are in
+ * running:			the index of the running process
+ * slice_expired:	whether the time quantum of the running process has run out
+ * now:				the current time
+ *
+ * Returns: 1 if the running process has to be preempted, 0 otherwise
+ */
+static int mlfq_should_preempt(void* ready, const struct process_table* table, int running, int slice_expired, long now) {
+	return slice_expired && mlfq_num_ready(ready) > 0;
+}
+
+/*
+ * Move a preempted process to the end of the queue of the next lower level (or of the lowest level, if it is
+ * already there).
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the process is in
+ * process:			the index of the preempted process
+ * slice_expired:	whether the time quantum of the process has run out
+ * now:				the current time
+ */
+static void mlfq_preempt(void* ready, const struct process_table* table, int process, int slice_expired, long now) {
+	struct mlfq_ready* current_ready = (struct mlfq_ready*) ready;
+	int level = current_ready->level[process];
+	if (level < current_ready->num_levels - 1) {
+		level++;
+	}
+	mlfq_enqueue(current_ready, process, level);
+}
+
+/*
+ * Write the Ready state to a checkpoint: the time of the next priority boost, the queue of every level and
+ * the level of the running process, which it keeps when it is preempted.
+ *
+ * ready:			a pointer to the Ready state
+ * running:			the index of the running process, or -1 if there is none
+ * checkpoint_file:	the checkpoint file
+ */
+static void mlfq_save(void* ready, int running, FILE* checkpoint_file) {
+	struct mlfq_ready* current_ready = (struct mlfq_ready*) ready;
+	fwrite(&current_ready->next_boost, sizeof(long), 1, checkpoint_file);
+	for (int i = 0; i < current_ready->num_levels; i++) {
+		save_queue(current_ready->levels[i], checkpoint_file);
+	}
+	if (running != -1) {
+		fwrite(&current_ready->level[running], sizeof(int), 1, checkpoint_file);
+	}
+}
+
+/*
+ * Read the Ready state written by mlfq_save() from a checkpoint into the empty Ready state.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the processes are in
+ * running:			the index of the running process, or -1 if there is none
+ * checkpoint_file:	the checkpoint file
+ *
+ * Returns: 0 on success, -1 if the checkpoint is damaged
+ */
+static int mlfq_load(void* ready, const struct process_table* table, int running, FILE* checkpoint_file) {
+	struct mlfq_ready* current_ready = (struct mlfq_ready*) ready;
+	if (current_ready->level_capacity < table->capacity) {
+		current_ready->level = (int*) arena_grow(current_ready->pool, current_ready->level, current_ready->level_capacity * sizeof(int), table->capacity * sizeof(int));
+		current_ready->level_capacity = table->capacity;
+	}
+	if (fread(&current_ready->next_boost, sizeof(long), 1, checkpoint_file) != 1) {
+		return -1;
+	}
+	for (int i = 0; i < current_ready->num_levels; i++) {
+		if (load_queue(current_ready->levels[i], table, checkpoint_file) != 0) {
+			return -1;
+		}
+		for (struct node* current_node = current_ready->levels[i]->head; current_node != NULL; current_node = current_node->next) {
+			current_ready->level[current_node->data] = i;
+		}
+		current_ready->size += current_ready->levels[i]->size;
+	}
+	if (running != -1) {
+		int level;
+		if (fread(&level, sizeof(int), 1, checkpoint_file) != 1 || level < 0 || level >= current_ready->num_levels) {
+			return -1;
+		}
+		current_ready->level[running] = level;
+	}
+	return 0;
+}
+
+/* The MLFQ scheduling policy. Like RR, arrivals never preempt the running process. */
+const struct policy mlfq_policy = {
+	"MLFQ", 0, mlfq_create, mlfq_add_ready, mlfq_num_ready, mlfq_select_next, mlfq_time_slice, mlfq_should_preempt, mlfq_preempt, mlfq_save, mlfq_load, NULL
+};
@@ -0,0 +1,215 @@
+/**
+ * Implementation of the memory pool used for the scheduling program. A pool owns every process and queue
+ * node created during a run, hands them out from large blocks instead of calling malloc() once per item,
+ * and releases all of them at once at the end of the run. A pool can also be reset, which takes back
+ * everything it has handed out but keeps its blocks, so that a pool used for run after run stops calling
+ * malloc() once it has grown large enough.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include "mydispatcher.h"
+
+/* The default size (in bytes) of a block of memory owned by a pool. */
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+/* Every piece of memory handed out by a pool is aligned to this many bytes. */
+#define ARENA_ALIGNMENT 16
+
+/* Representation of a block of memory owned by a pool. The usable memory follows right after this header. */
+struct arena_block {
+	struct arena_block* next;	// the next block in the list the block is in
+	size_t size;				// the number of usable bytes in this block
+};
+
+/* The size of a block header, rounded up so that the usable memory is aligned. */
+#define ARENA_HEADER_SIZE ((sizeof(struct arena_block) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1))
+
+/*
+ * Create a new, empty memory pool.
+ *
+ * Returns: a pointer to the created pool
+ */
+struct arena* create_arena() {
+	struct arena* created_arena = (struct arena*) malloc(sizeof(struct arena));
+
+	/* No block is allocated until the first request. */
+	created_arena->blocks = NULL;
+	created_arena->spare_blocks = NULL;
+	created_arena->next_free = NULL;
+	created_arena->remaining_bytes = 0;
+	created_arena->free_nodes = NULL;
+	created_arena->num_allocations = 1;
+	created_arena->allocated_bytes = sizeof(struct arena);
+	created_arena->out_of_memory = NULL;
+
+	return created_arena;
+}
+
+/*
+ * Take the smallest spare block of a specified pool that can hold a specified number of bytes off its list
+ * of spare blocks.
+ *
+ * current_arena:	a pointer to the pool
+ * size:			the number of usable bytes needed
+ *
+ * Returns: a pointer to the block, or NULL if no spare block is large enough
+ */
+static struct arena_block* take_spare_block(struct arena* current_arena, size_t size) {
+	struct arena_block** best_link = NULL;
+	for (struct arena_block** link = &current_arena->spare_blocks; *link != NULL; link = &(*link)->next) {
+		if ((*link)->size >= size && (best_link == NULL || (*link)->size < (*best_link)->size)) {
+			best_link = link;
+		}
+	}
+	if (best_link == NULL) {
+		return NULL;
+	}
+	struct arena_block* taken_block = *best_link;
+	*best_link = taken_block->next;
+	return taken_block;
+}
+
+/*
+ * Hand out a piece of memory of a specified size from a specified pool. The memory stays valid until the
+ * pool is destroyed and must not be passed to free().
+ *
+ * current_arena:	a pointer to the pool to allocate from
+ * size:			the number of bytes needed
+ *
+ * Returns: a pointer to the memory
+ */
+void* arena_alloc(struct arena* current_arena, size_t size) {
+	/* Round the size up so that the next piece handed out is also aligned. */
+	size = (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+
+	if (size > current_arena->remaining_bytes) {
+		/* If the current block cannot hold the request, move on to a spare block that can, or allocate a new
+		 * block. A request larger than the default block size gets a block of its own. The unused end of the
+		 * old block is simply abandoned. */
+		size_t block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+		struct arena_block* new_block = take_spare_block(current_arena, size);
+		if (new_block == NULL) {
+			new_block = (struct arena_block*) malloc(ARENA_HEADER_SIZE + block_size);
+			if (new_block == NULL) {
+				/* A program that embeds the scheduler gets control back instead of being exited. */
+				if (current_arena->out_of_memory != NULL) {
+					longjmp(*current_arena->out_of_memory, 1);
+				}
+				printf("ERROR: Out of memory!\n");
+				exit(1);
+			}
+			new_block->size = block_size;
+
+			/* Count every call to malloc() made on behalf of the pool. */
+			current_arena->num_allocations++;
+			current_arena->allocated_bytes += ARENA_HEADER_SIZE + block_size;
+		}
+		new_block->next = current_arena->blocks;
+		current_arena->blocks = new_block;
+		current_arena->next_free = (char*) new_block + ARENA_HEADER_SIZE;
+		current_arena->remaining_bytes = new_block->size;
+	}
+
+	void* piece = current_arena->next_free;
+	current_arena->next_free += size;
+	current_arena->remaining_bytes -= size;
+	return piece;
+}
+
+/*
+ * Grow a piece of memory previously handed out by a specified pool. The contents are copied to a new piece,
+ * and the old piece is left unused until the pool is destroyed, so this should only be used with geometric
+ * growth.
+ *
+ * current_arena:	a pointer to the pool the memory belongs to
+ * old_piece:		a pointer to the memory to be grown
+ * old_size:		the number of bytes currently in use
+ * new_size:		the number of bytes needed
+ *
+ * Returns: a pointer to the grown memory
+ */
+void* arena_grow(struct arena* current_arena, void* old_piece, size_t old_size, size_t new_size) {
+	void* new_piece = arena_alloc(current_arena, new_size);
+	if (old_size > 0) {
+		memcpy(new_piece, old_piece, old_size);
+	}
+	return new_piece;
+}
+
+/*
+ * Get a queue node from a specified pool, reusing a released node if one is available.
+ *
+ * current_arena:	a pointer to the pool to take the node from
+ *
+ * Returns: a pointer to the node
+ */
+struct node* arena_alloc_node(struct arena* current_arena) {
+	struct node* taken_node = current_arena->free_nodes;
+	if (taken_node != NULL) {
+		/* If some node has been released, take it from the free-list. */
+		current_arena->free_nodes = taken_node->next;
+		return taken_node;
+	}
+	return (struct node*) arena_alloc(current_arena, sizeof(struct node));
+}
+
+/*
+ * Give a queue node back to a specified pool so that it can be reused by a later call to arena_alloc_node().
+ *
+ * current_arena:	a pointer to the pool the node belongs to
+ * node_to_release:	a pointer to the node to be released
+ */
+void arena_release_node(struct arena* current_arena, struct node* node_to_release) {
+	/* The free-list is linked through the next pointers of the released nodes. */
+	node_to_release->next = current_arena->free_nodes;
+	current_arena->free_nodes = node_to_release;
+}
+
+/*
+ * Take back every piece of memory a specified pool has handed out, which must no longer be used. The blocks
+ * of the pool are kept as spare blocks, and later requests are served from them before any new block is
+ * allocated.
+ *
+ * current_arena:	a pointer to the pool to be reset
+ */
+void reset_arena(struct arena* current_arena) {
+	while (current_arena->blocks != NULL) {
+		struct arena_block* current_block = current_arena->blocks;
+		current_arena->blocks = current_block->next;
+		current_block->next = current_arena->spare_blocks;
+		current_arena->spare_blocks = current_block;
+	}
+	current_arena->next_free = NULL;
+	current_arena->remaining_bytes = 0;
+	current_arena->free_nodes = NULL;
+}
+
+/*
+ * Deallocate a list of blocks of memory.
+ *
+ * current_block:	a pointer to the first block of the list
+ */
+static void free_blocks(struct arena_block* current_block) {
+	while (current_block != NULL) {
+		struct arena_block* next_block = current_block->next;
+		free(current_block);
+		current_block = next_block;
+	}
+}
+
+/*
+ * Deallocate a specified pool together with every piece of memory it has handed out.
+ *
+ * current_arena:	a pointer to the pool to be deallocated
+ */
+void destroy_arena(struct arena* current_arena) {
+	free_blocks(current_arena->blocks);
+	free_blocks(current_arena->spare_blocks);
+	free(current_arena);
+}
@@ -0,0 +1,364 @@
+/**
+ * Implementation of batches, which simulate a scheduling policy over many traces (such as one trace per host)
+ * in one run. The traces are the files in a directory or the files listed in a file. Each trace is read and
+ * simulated by a task of its own on a work-stealing thread pool, with its own memory pool and its own output
+ * file, so that the traces share nothing but the settings and the batch scales with the number of processors.
+ * The averages of every trace are written as CSV.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "mydispatcher.h"
+
+/*
+ * Join two strings, with an optional separator between them, into a string taken from a memory pool.
+ *
+ * first:			the first string
+ * first_length:	the number of characters of the first string to use
+ * separator:		the separator, or '\0' for none
+ * second:			the second string
+ * second_length:	the number of characters of the second string to use
+ * pool:			a pointer to the memory pool that owns the joined string
+ *
+ * Returns: a pointer to the joined string
+ */
+static char* join_strings(const char* first, size_t first_length, char separator, const char* second, size_t second_length, struct arena* pool) {
+	char* joined = (char*) arena_alloc(pool, first_length + 1 + second_length + 1);
+	char* cursor = joined;
+	memcpy(cursor, first, first_length);
+	cursor += first_length;
+	if (separator != '\0') {
+		*cursor++ = separator;
+	}
+	memcpy(cursor, second, second_length);
+	cursor[second_length] = '\0';
+	return joined;
+}
+
+/*
+ * Add a trace to the end of the traces of a batch. Its output file is named after the last part of its path,
+ * with ".out" (or ".bin" for binary event logs) appended, in the output directory.
+ *
+ * path:			the path of the trace
+ * path_length:		the number of characters of the path
+ * output_dir:		the directory the output files are written to
+ * settings:		a pointer to the settings shared by every trace
+ * pool:			a pointer to the memory pool that owns the traces
+ * traces:			a pointer to the array of traces, which is moved if it has to grow
+ * num_traces:		the number of traces in the array
+ * capacity:		a pointer to the number of traces the array can hold
+ */
+static void add_batch_trace(const char* path, size_t path_length, const char* output_dir, const struct batch_settings* settings, struct arena* pool, struct batch_trace** traces, int num_traces, int* capacity) {
+	if (num_traces == *capacity) {
+		int new_capacity = *capacity > 0 ? 2 * *capacity : 64;
+		*traces = (struct batch_trace*) arena_grow(pool, *traces, *capacity * sizeof(struct batch_trace), new_capacity * sizeof(struct batch_trace));
+		*capacity = new_capacity;
+	}
+	struct batch_trace* trace = &(*traces)[num_traces];
+	memset(trace, 0, sizeof(struct batch_trace));
+	trace->input_path = join_strings(path, path_length, '\0', "", 0, pool);
+	trace->settings = settings;
+
+	const char* name = strrchr(trace->input_path, '/');
+	name = name != NULL ? name + 1 : trace->input_path;
+	char* output_name = join_strings(name, strlen(name), '\0', settings->output_format == OUTPUT_BINARY ? ".bin" : ".out", 4, pool);
+	trace->output_path = join_strings(output_dir, strlen(output_dir), '/', output_name, strlen(output_name), pool);
+
+	/* A trace that cannot be looked at now is reported when it is read. */
+	struct stat trace_info;
+	trace->size = stat(trace->input_path, &trace_info) == 0 ? (long) trace_info.st_size : 0;
+}
+
+/*
+ * Compare two traces by their paths, for qsort().
+ *
+ * first:	a pointer to the first trace
+ * second:	a pointer to the second trace
+ *
+ * Returns: a negative number, 0 or a positive number as the path of the first trace comes before, is equal to
+ *			or comes after the path of the second
+ */
+static int compare_trace_paths(const void* first, const void* second) {
+	return strcmp(((const struct batch_trace*) first)->input_path, ((const struct batch_trace*) second)->input_path);
+}
+
+/*
+ * Add every file in a directory to the traces of a batch, in order of their names. Hidden files (whose names
+ * start with a dot) and anything that is not a regular file are skipped.
+ *
+ * source:		the path of the directory
+ * output_dir:	the directory the output files are written to
+ * settings:	a pointer to the settings shared by every trace
+ * pool:		a pointer to the memory pool that owns the traces
+ * traces:		a pointer to the array of traces, which is moved if it has to grow
+ * capacity:	a pointer to the number of traces the array can hold
+ *
+ * Returns: the number of traces, or -1 if the directory cannot be read (an error statement is printed out in
+ *			that case)
+ */
+static int collect_directory_traces(const char* source, const char* output_dir, const struct batch_settings* settings, struct arena* pool, struct batch_trace** traces, int* capacity) {
+	DIR* directory = opendir(source);
+	if (directory == NULL) {
+		printf("ERROR: Cannot open directory \"%s\"!\n", source);
+		return -1;
+	}
+	int num_traces = 0;
+	struct dirent* entry;
+	while ((entry = readdir(directory)) != NULL) {
+		if (entry->d_name[0] == '.') {
+			continue;
+		}
+		char* path = join_strings(source, strlen(source), '/', entry->d_name, strlen(entry->d_name), pool);
+		struct stat entry_info;
+		if (stat(path, &entry_info) == 0 && S_ISREG(entry_info.st_mode)) {
+			add_batch_trace(path, strlen(path), output_dir, settings, pool, traces, num_traces++, capacity);
+		}
+	}
+	closedir(directory);
+
+	/* readdir() returns the files in no particular order, so sort them to make the batch reproducible. */
+	if (num_traces > 0) {
+		qsort(*traces, num_traces, sizeof(struct batch_trace), compare_trace_paths);
+	}
+	return num_traces;
+}
+
+/*
+ * Add every file listed in a file, one path per line, to the traces of a batch, in the order they are listed.
+ * Blank lines are skipped, and whitespace at the end of a line is not part of the path.
+ *
+ * source:		the path of the list
+ * output_dir:	the directory the output files are written to
+ * settings:	a pointer to the settings shared by every trace
+ * pool:		a pointer to the memory pool that owns the traces
+ * traces:		a pointer to the array of traces, which is moved if it has to grow
+ * capacity:	a pointer to the number of traces the array can hold
+ *
+ * Returns: the number of traces, or -1 if the list cannot be read (an error statement is printed out in that
+ *			case)
+ */
+static int collect_listed_traces(const char* source, const char* output_dir, const struct batch_settings* settings, struct arena* pool, struct batch_trace** traces, int* capacity) {
+	FILE* list_file = fopen(source, "r");
+	if (list_file == NULL) {
+		printf("ERROR: Cannot open file \"%s\"!\n", source);
+		return -1;
+	}
+	int num_traces = 0;
+	char* line = NULL;
+	size_t line_capacity = 0;
+	ssize_t line_length;
+	while ((line_length = getline(&line, &line_capacity, list_file)) != -1) {
+		while (line_length > 0 && (line[line_length - 1] == '\n' || line[line_length - 1] == '\r' || line[line_length - 1] == ' ' || line[line_length - 1] == '\t')) {
+			line_length--;
+		}
+		if (line_length > 0) {
+			add_batch_trace(line, line_length, output_dir, settings, pool, traces, num_traces++, capacity);
+		}
+	}
+	free(line);
+	fclose(list_file);
+	return num_traces;
+}
+
+/*
+ * Compare two traces by the paths of their output files, for qsort().
+ *
+ * first:	a pointer to a pointer to the first trace
+ * second:	a pointer to a pointer to the second trace
+ *
+ * Returns: a negative number, 0 or a positive number as the output path of the first trace comes before, is
+ *			equal to or comes after that of the second
+ */
+static int compare_output_paths(const void* first, const void* second) {
+	return strcmp((*(struct batch_trace* const*) first)->output_path, (*(struct batch_trace* const*) second)->output_path);
+}
+
+/*
+ * Find the traces of a batch. If the source is a directory, every regular file in it is a trace, in order of
+ * their names; otherwise the source is a file listing the paths of the traces, one per line. The output file
+ * of each trace is named after the last part of its path, so no two traces may have the same file name.
+ *
+ * source:		the path of the directory or the list
+ * output_dir:	the directory the output files are written to
+ * settings:	a pointer to the settings shared by every trace
+ * pool:		a pointer to the memory pool that owns the traces
+ * traces:		a pointer to where a pointer to the array of traces is stored
+ *
+ * Returns: the number of traces, or -1 if the source cannot be read, has no traces or has two traces with the
+ *			same file name (an error statement is printed out in that case)
+ */
+int collect_batch_traces(const char* source, const char* output_dir, const struct batch_settings* settings, struct arena* pool, struct batch_trace** traces) {
+	*traces = NULL;
+	int capacity = 0;
+	struct stat source_info;
+	int num_traces;
+	if (stat(source, &source_info) == 0 && S_ISDIR(source_info.st_mode)) {
+		num_traces = collect_directory_traces(source, output_dir, settings, pool, traces, &capacity);
+	} else {
+		num_traces = collect_listed_traces(source, output_dir, settings, pool, traces, &capacity);
+	}
+	if (num_traces == 0) {
+		printf("ERROR: There are no traces in \"%s\"!\n", source);
+		return -1;
+	} else if (num_traces < 0) {
+		return -1;
+	}
+
+	/* Two traces with the same file name would overwrite each other's output, which sorting by output path
+	 * brings next to each other. */
+	struct batch_trace** by_output = (struct batch_trace**) arena_alloc(pool, num_traces * sizeof(struct batch_trace*));
+	for (int i = 0; i < num_traces; i++) {
+		by_output[i] = &(*traces)[i];
+	}
+	qsort(by_output, num_traces, sizeof(struct batch_trace*), compare_output_paths);
+	for (int i = 1; i < num_traces; i++) {
+		if (strcmp(by_output[i - 1]->output_path, by_output[i]->output_path) == 0) {
+			printf("ERROR: Traces \"%s\" and \"%s\" would both be written to \"%s\"!\n", by_output[i - 1]->input_path, by_output[i]->input_path, by_output[i]->output_path);
+			return -1;
+		}
+	}
+	return num_traces;
+}
+
+/*
+ * Read and simulate one trace of a batch, writing its results to its output file. This is the task run by
+ * the thread pool.
+ *
+ * argument:	a pointer to the batch_trace describing the trace
+ */
+static void batch_task(void* argument) {
+	struct batch_trace* trace = (struct batch_trace*) argument;
+	const struct batch_settings* settings = trace->settings;
+
+	/* Every task has its own memory pool, which owns the table, the state of the simulation and the buffer of
+	 * the output file, and is released as soon as the trace is done. */
+	struct arena* pool = create_arena();
+	struct process_table* table = read_input(trace->input_path, pool, NULL);
+	if (table == NULL) {
+		/* An error statement has already been printed out. */
+		trace->error = 1;
+		destroy_arena(pool);
+		return;
+	}
+	struct output_writer* output = open_output_writer(trace->output_path, settings->output_format, 0, pool);
+	if (output == NULL) {
+		printf("ERROR: Cannot open/create file \"%s\"\n", trace->output_path);
+		trace->error = 1;
+		destroy_arena(pool);
+		return;
+	}
+
+	struct arrival_stream arrivals;
+	init_table_stream(&arrivals, table);
+	trace->results.latency = NULL;
+	trace->results.checkpoint = NULL;
+	trace->results.what_if = NULL;
+	if (settings->num_cpus > 1) {
+		struct smp_results smp_results;
+		simulate_smp(settings->policy, settings->params, settings->num_cpus, settings->queue_mode, &arrivals, output, pool, &trace->results, &smp_results);
+	} else {
+		simulate(settings->policy, settings->params, &arrivals, output, pool, &trace->results);
+	}
+	if (close_output_writer(output) != 0) {
+		printf("ERROR: Cannot write file \"%s\"\n", trace->output_path);
+		trace->error = 1;
+	}
+	destroy_arena(pool);
+}
+
+/*
+ * Compare two traces so that the larger one comes first, or the one listed first if they are the same size,
+ * for qsort().
+ *
+ * first:	a pointer to a pointer to the first trace
+ * second:	a pointer to a pointer to the second trace
+ *
+ * Returns: a negative number if the first trace comes first, a positive number otherwise
+ */
+static int compare_trace_sizes(const void* first, const void* second) {
+	const struct batch_trace* first_trace = *(struct batch_trace* const*) first;
+	const struct batch_trace* second_trace = *(struct batch_trace* const*) second;
+	if (first_trace->size != second_trace->size) {
+		return first_trace->size > second_trace->size ? -1 : 1;
+	}
+	return first_trace < second_trace ? -1 : 1;
+}
+
+/*
+ * Write a path as a field of CSV, in double quotes if it contains a comma, a double quote or a line break.
+ *
+ * csv_file:	the CSV file
+ * path:		the path to write
+ */
+static void write_csv_path(FILE* csv_file, const char* path) {
+	if (strpbrk(path, ",\"\r\n") == NULL) {
+		fputs(path, csv_file);
+		return;
+	}
+	fputc('"', csv_file);
+	for (const char* cursor = path; *cursor != '\0'; cursor++) {
+		if (*cursor == '"') {
+			fputc('"', csv_file);
+		}
+		fputc(*cursor, csv_file);
+	}
+	fputc('"', csv_file);
+}
+
+/*
+ * Read and simulate every trace of a batch on a work-stealing thread pool, then write one line of CSV per
+ * trace with the number of processes and events and the averages. The largest traces are started first, so
+ * that a large trace left for the end does not keep the other threads waiting. A trace that cannot be read
+ * or written does not stop the others, and is left out of the CSV.
+ *
+ * traces:		an array of traces, as found by collect_batch_traces()
+ * num_traces:	the number of traces
+ * num_threads:	the number of worker threads
+ * csv_path:	the path of the CSV file to write
+ *
+ * Returns: the number of traces that could not be simulated, or -1 if the CSV file cannot be written (an
+ *			error statement is printed out in either case)
+ */
+int run_batch(struct batch_trace* traces, int num_traces, int num_threads, const char* csv_path) {
+	struct batch_trace** by_size = (struct batch_trace**) malloc(num_traces * sizeof(struct batch_trace*));
+	for (int i = 0; i < num_traces; i++) {
+		by_size[i] = &traces[i];
+	}
+	qsort(by_size, num_traces, sizeof(struct batch_trace*), compare_trace_sizes);
+	struct thread_pool* pool = create_thread_pool(num_threads);
+	for (int i = 0; i < num_traces; i++) {
+		thread_pool_submit(pool, batch_task, by_size[i]);
+	}
+	destroy_thread_pool(pool);
+	free(by_size);
+
+	FILE* csv_file = fopen(csv_path, "w");
+	if (csv_file == NULL) {
+		printf("ERROR: Cannot open/create file \"%s\"\n", csv_path);
+		return -1;
+	}
+	fprintf(csv_file, "trace,processes,events,average_turnaround,average_normalized_turnaround,average_waiting\n");
+	int num_errors = 0;
+	for (int i = 0; i < num_traces; i++) {
+		const struct sim_results* results = &traces[i].results;
+		if (traces[i].error) {
+			num_errors++;
+			continue;
+		}
+		int count = results->num_processes > 0 ? results->num_processes : 1;
+		write_csv_path(csv_file, traces[i].input_path);
+		fprintf(csv_file, ",%d,%ld,%f,%f,%f\n", results->num_processes, results->num_events, sum_value(&results->sum_turnaround)/count, sum_value(&results->sum_normalized_turnaround)/count, sum_value(&results->sum_waiting)/count);
+	}
+	if (fclose(csv_file) != 0) {
+		printf("ERROR: Cannot write file \"%s\"\n", csv_path);
+		return -1;
+	}
+	return num_errors;
+}
@@ -0,0 +1,490 @@
+/**
+ * Implementation of checkpoints of a simulation. Every few seconds, the whole state of the simulation loop is
+ * written to a compact binary checkpoint file: the clock, the running process, the position in the stream of
+ * arrivals, the running totals, the remaining times of the processes that have run partly, the Ready state of
+ * the policy and the size of the output written so far. A simulation resumed from the checkpoint cuts the
+ * output file back to that size and carries on, so that its output is the same as that of a run that was
+ * never interrupted.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include "mydispatcher.h"
+
+/* The first bytes of a checkpoint file, followed by the format version. */
+static const char CHECKPOINT_MAGIC[8] = { 'M', 'Y', 'D', 'C', 'K', 'P', 'T', '\0' };
+#define CHECKPOINT_VERSION 4
+
+/* The last bytes of a checkpoint file, which tell a complete checkpoint from a cut-off one. */
+#define CHECKPOINT_END 0x444E4521
+
+/* Representation of the start of a checkpoint file, which tells what the simulation was. All fields are
+ * stored in the byte order of the machine that wrote the checkpoint. */
+struct checkpoint_header {
+	char magic[8];					// CHECKPOINT_MAGIC
+	int version;					// CHECKPOINT_VERSION
+	char policy[16];				// the name of the scheduling policy
+	struct policy_params params;	// the parameters of the policy
+	int output_format;				// the format of the output file
+	int num_processes;				// the number of processes in the input
+	unsigned long input_hash;		// a hash of the arrival and service times of the input
+	long output_size;				// the number of bytes of the output file written so far
+	int first_row;					// the first row whose process may not have completed (all before it have)
+};
+
+/*
+ * Work out a hash (64-bit FNV-1a) of the arrival and service times of a table of processes, so that a
+ * checkpoint is only resumed with the input it was taken from.
+ *
+ * table:	a pointer to the table of processes
+ *
+ * Returns: the hash
+ */
+static unsigned long hash_input(const struct process_table* table) {
+	unsigned long hash = 0xCBF29CE484222325UL;
+	for (int i = 0; i < table->size; i++) {
+		hash = (hash ^ (unsigned long) table->arrival_time[i]) * 0x100000001B3UL;
+		hash = (hash ^ (unsigned long) table->service_time[i]) * 0x100000001B3UL;
+	}
+	return hash;
+}
+
+/*
+ * Create the state for writing checkpoints of a simulation and resuming it.
+ *
+ * path:		the path of the checkpoint file to write, or NULL to write none (when only resuming)
+ * interval:	the number of seconds between checkpoints
+ * pool:		a pointer to the memory pool the state is taken from
+ *
+ * Returns: a pointer to the state
+ */
+struct checkpointer* create_checkpointer(const char* path, double interval, struct arena* pool) {
+	struct checkpointer* checkpoint = (struct checkpointer*) arena_alloc(pool, sizeof(struct checkpointer));
+	checkpoint->path = path;
+	checkpoint->interval = interval;
+	checkpoint->next_seconds = current_seconds() + interval;
+	checkpoint->steps = 0;
+	checkpoint->input_hashed = 0;
+	checkpoint->resume_file = NULL;
+	checkpoint->output_size = 0;
+	checkpoint->first_row = 0;
+	checkpoint->num_written = 0;
+	checkpoint->error = 0;
+	return checkpoint;
+}
+
+/*
+ * Open a checkpoint to resume from and check that it was taken with the same policy, parameters and output
+ * format. The rest of the checkpoint is read by load_checkpoint() once the simulation has started. If the
+ * checkpoint cannot be read or does not match, an error statement is printed out.
+ *
+ * checkpoint:		a pointer to the checkpoint state, whose output_size is set to the size of the output
+ *					file when the checkpoint was taken
+ * resume_path:		the path of the checkpoint file
+ * policy:			a pointer to the scheduling policy
+ * params:			a pointer to the parameters of the policy
+ * output_format:	the format of the output file
+ *
+ * Returns: 0 on success, -1 if an error occurs
+ */
+int open_checkpoint(struct checkpointer* checkpoint, const char* resume_path, const struct policy* policy, const struct policy_params* params, int output_format) {
+	FILE* resume_file = fopen(resume_path, "rb");
+	if (resume_file == NULL) {
+		printf("ERROR: Cannot open file \"%s\"!\n", resume_path);
+		return -1;
+	}
+	struct checkpoint_header header;
+	if (fread(&header, sizeof(header), 1, resume_file) != 1 || memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0 || header.version != CHECKPOINT_VERSION) {
+		printf("ERROR: \"%s\" is not a checkpoint!\n", resume_path);
+		fclose(resume_file);
+		return -1;
+	}
+	if (strncmp(header.policy, policy->name, sizeof(header.policy)) != 0 || header.params.quantum != params->quantum || header.params.num_levels != params->num_levels
+			|| header.params.boost_interval != params->boost_interval || header.params.aging_interval != params->aging_interval || header.output_format != output_format) {
+		printf("ERROR: The checkpoint \"%s\" was taken with another policy, other parameters or another output format!\n", resume_path);
+		fclose(resume_file);
+		return -1;
+	}
+	if (header.first_row < 0 || header.first_row > header.num_processes) {
+		printf("ERROR: The checkpoint \"%s\" is damaged!\n", resume_path);
+		fclose(resume_file);
+		return -1;
+	}
+	checkpoint->resume_file = resume_file;
+	checkpoint->resume_processes = header.num_processes;
+	checkpoint->first_row = header.first_row;
+	checkpoint->resume_hash = header.input_hash;
+	checkpoint->output_size = header.output_size;
+	return 0;
+}
+
+/*
+ * Write the state of a simulation loop to a stream: the clock, the running process, the position in the stream
+ * of arrivals, the running totals, the remaining times of the processes that have run and the Ready
+ * state of the policy, followed by an end marker. This is the body of a checkpoint, and also what the
+ * snapshots of a what-if analysis keep in memory.
+ *
+ * state_file:	the stream to write to
+ * policy:		a pointer to the scheduling policy
+ * ready:		a pointer to the Ready state of the policy
+ * arrivals:	a pointer to the stream of arriving processes, which must hold the whole input
+ * snapshot:	a pointer to the state of the simulation loop
+ * results:		a pointer to the running totals
+ * first_row:	the first row of the table whose process may not have completed, so that the rows before it
+ *				need not be looked at
+ */
+void write_sim_state(FILE* state_file, const struct policy* policy, void* ready, const struct arrival_stream* arrivals, const struct sim_snapshot* snapshot, const struct sim_results* results, int first_row) {
+	const struct process_table* table = arrivals->table;
+
+	/* The state of the loop and the running totals. */
+	fwrite(snapshot, sizeof(struct sim_snapshot), 1, state_file);
+	fwrite(&arrivals->next, sizeof(int), 1, state_file);
+	fwrite(&results->num_processes, sizeof(int), 1, state_file);
+	fwrite(&results->sum_turnaround, sizeof(struct compensated_sum), 1, state_file);
+	fwrite(&results->sum_normalized_turnaround, sizeof(struct compensated_sum), 1, state_file);
+	fwrite(&results->sum_waiting, sizeof(struct compensated_sum), 1, state_file);
+	fwrite(&results->num_events, sizeof(long), 1, state_file);
+
+	/* The remaining times that differ from the service times, as pairs of a row and a remaining time, and the
+	 * remaining time of the running process, which may be about to complete. This includes the rows from the
+	 * first row that have completed (remaining time 0), so that they are still seen as completed after
+	 * resuming and the first row keeps moving past them. */
+	int num_partial = 0;
+	for (int i = first_row; i < arrivals->next; i++) {
+		num_partial += table->remaining_time[i] < table->service_time[i] || i == snapshot->running_process;
+	}
+	fwrite(&num_partial, sizeof(int), 1, state_file);
+	for (int i = first_row; i < arrivals->next; i++) {
+		if (table->remaining_time[i] < table->service_time[i] || i == snapshot->running_process) {
+			fwrite(&i, sizeof(int), 1, state_file);
+			fwrite(&table->remaining_time[i], sizeof(long), 1, state_file);
+		}
+	}
+
+	/* The Ready state of the policy, then the end marker. */
+	policy->save(ready, snapshot->running_process, state_file);
+	int end = CHECKPOINT_END;
+	fwrite(&end, sizeof(int), 1, state_file);
+}
+
+/*
+ * Read the state of a simulation loop written by write_sim_state() into a simulation that has just started:
+ * restore the state of the loop, the running totals, the remaining times and the Ready state of the policy.
+ *
+ * state_file:	the stream to read from
+ * policy:		a pointer to the scheduling policy
+ * ready:		a pointer to the (empty) Ready state of the policy
+ * arrivals:	a pointer to the stream of arriving processes, which must hold the whole input
+ * snapshot:	a pointer to where the state of the simulation loop is stored
+ * results:		a pointer to where the running totals are stored
+ *
+ * Returns: 0 on success, -1 if the state is cut off or damaged
+ */
+int read_sim_state(FILE* state_file, const struct policy* policy, void* ready, struct arrival_stream* arrivals, struct sim_snapshot* snapshot, struct sim_results* results) {
+	struct process_table* table = arrivals->table;
+
+	/* The totals and the position in the stream are only taken over once the whole state has been read, so
+	 * that the results stay empty if it is damaged. */
+	struct sim_results totals;
+	int next_arrival;
+	int valid = fread(snapshot, sizeof(struct sim_snapshot), 1, state_file) == 1
+		&& fread(&next_arrival, sizeof(int), 1, state_file) == 1
+		&& fread(&totals.num_processes, sizeof(int), 1, state_file) == 1
+		&& fread(&totals.sum_turnaround, sizeof(struct compensated_sum), 1, state_file) == 1
+		&& fread(&totals.sum_normalized_turnaround, sizeof(struct compensated_sum), 1, state_file) == 1
+		&& fread(&totals.sum_waiting, sizeof(struct compensated_sum), 1, state_file) == 1
+		&& fread(&totals.num_events, sizeof(long), 1, state_file) == 1
+		&& next_arrival >= 0 && next_arrival <= table->size
+		&& snapshot->running_process >= -1 && snapshot->running_process < next_arrival;
+
+	int num_partial = 0;
+	valid = valid && fread(&num_partial, sizeof(int), 1, state_file) == 1;
+	for (int i = 0; valid && i < num_partial; i++) {
+		int process;
+		long remaining;
+		valid = read_checkpoint_process(state_file, table, &process) == 0 && fread(&remaining, sizeof(long), 1, state_file) == 1
+			&& remaining >= 0 && remaining <= table->service_time[process];
+		if (valid) {
+			table->remaining_time[process] = remaining;
+		}
+	}
+
+	int end = 0;
+	valid = valid && policy->load(ready, table, snapshot->running_process, state_file) == 0
+		&& fread(&end, sizeof(int), 1, state_file) == 1 && end == CHECKPOINT_END;
+	if (!valid) {
+		return -1;
+	}
+	arrivals->next = next_arrival;
+	results->num_processes = totals.num_processes;
+	results->sum_turnaround = totals.sum_turnaround;
+	results->sum_normalized_turnaround = totals.sum_normalized_turnaround;
+	results->sum_waiting = totals.sum_waiting;
+	results->num_events = totals.num_events;
+	return 0;
+}
+
+/*
+ * Wait until the entries of the directory a file is in are on disk, so that a file renamed into it stays
+ * renamed after a crash.
+ *
+ * path:	the path of the file
+ *
+ * Returns: 0 on success, -1 if the directory cannot be synced
+ */
+static int sync_directory(const char* path) {
+	char directory[1024];
+	const char* last_slash = strrchr(path, '/');
+	if (last_slash == NULL) {
+		strcpy(directory, ".");
+	} else if (last_slash == path) {
+		strcpy(directory, "/");
+	} else {
+		snprintf(directory, sizeof(directory), "%.*s", (int) (last_slash - path), path);
+	}
+	int directory_fd = open(directory, O_RDONLY);
+	if (directory_fd < 0) {
+		return -1;
+	}
+	int result = fsync(directory_fd);
+	close(directory_fd);
+	return result;
+}
+
+/*
+ * Write a checkpoint of a simulation. The checkpoint is written to a temporary file first, synced to disk and
+ * then renamed, and the directory is synced afterwards, so that a crash at any point leaves either the
+ * previous checkpoint or the new one in place. Only the rows from the first one whose process may not have
+ * completed are looked at, as in take_what_if_snapshot(). If the checkpoint cannot be written, an error
+ * statement is printed out and no more checkpoints are taken.
+ *
+ * checkpoint:	a pointer to the checkpoint state
+ * policy:		a pointer to the scheduling policy
+ * params:		a pointer to the parameters of the policy
+ * ready:		a pointer to the Ready state of the policy
+ * arrivals:	a pointer to the stream of arriving processes, which must hold the whole input
+ * output:		a pointer to the output writer, which is flushed so that the output file is up to date
+ * snapshot:	a pointer to the state of the simulation loop
+ * results:		a pointer to the running totals
+ */
+void save_checkpoint(struct checkpointer* checkpoint, const struct policy* policy, const struct policy_params* params, void* ready, const struct arrival_stream* arrivals, struct output_writer* output, const struct sim_snapshot* snapshot, const struct sim_results* results) {
+	const struct process_table* table = arrivals->table;
+	if (!checkpoint->input_hashed) {
+		checkpoint->input_hash = hash_input(table);
+		checkpoint->input_hashed = 1;
+	}
+
+	/* Everything written to the output so far must be in the output file, and on disk, before the checkpoint
+	 * refers to it. */
+	if (sync_output_writer(output) != 0) {
+		return;
+	}
+	if (output->fd >= 0 && fsync(output->fd) != 0 && errno != EINVAL) {
+		printf("ERROR: Cannot write the output file!\n");
+		checkpoint->error = 1;
+		checkpoint->path = NULL;
+		return;
+	}
+
+	/* The rows before the first one whose process may not have completed never change again. */
+	while (checkpoint->first_row < arrivals->next && table->remaining_time[checkpoint->first_row] == 0 && checkpoint->first_row != snapshot->running_process) {
+		checkpoint->first_row++;
+	}
+
+	char temporary_path[1024];
+	snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", checkpoint->path);
+	FILE* checkpoint_file = fopen(temporary_path, "wb");
+	if (checkpoint_file == NULL) {
+		printf("ERROR: Cannot open/create file \"%s\"\n", temporary_path);
+		checkpoint->error = 1;
+		checkpoint->path = NULL;
+		return;
+	}
+
+	struct checkpoint_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+	header.version = CHECKPOINT_VERSION;
+	strncpy(header.policy, policy->name, sizeof(header.policy) - 1);
+	header.params = *params;
+	header.output_format = output->format;
+	header.num_processes = table->size;
+	header.input_hash = checkpoint->input_hash;
+	header.output_size = output->size;
+	header.first_row = checkpoint->first_row;
+	fwrite(&header, sizeof(header), 1, checkpoint_file);
+
+	write_sim_state(checkpoint_file, policy, ready, arrivals, snapshot, results, checkpoint->first_row);
+
+	int write_error = fflush(checkpoint_file) != 0 || ferror(checkpoint_file) || fsync(fileno(checkpoint_file)) != 0;
+	write_error |= fclose(checkpoint_file) != 0;
+	if (write_error || rename(temporary_path, checkpoint->path) != 0 || sync_directory(checkpoint->path) != 0) {
+		printf("ERROR: Cannot write file \"%s\"\n", checkpoint->path);
+		checkpoint->error = 1;
+		checkpoint->path = NULL;
+		return;
+	}
+	checkpoint->num_written++;
+}
+
+/*
+ * Read a process index from a checkpoint and check that it is a row of a table of processes.
+ *
+ * checkpoint_file:	the checkpoint file
+ * table:			a pointer to the table of processes
+ * process:			a pointer to where the index is stored
+ *
+ * Returns: 0 on success, -1 if the checkpoint is cut off or the index is not a row of the table
+ */
+int read_checkpoint_process(FILE* checkpoint_file, const struct process_table* table, int* process) {
+	if (fread(process, sizeof(int), 1, checkpoint_file) != 1 || *process < 0 || *process >= table->size) {
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Resume a simulation from the checkpoint opened by open_checkpoint(): restore the state of the loop, the
+ * running totals, the remaining times and the Ready state of the policy. The checkpoint file is closed
+ * afterwards. If the checkpoint was taken with another input or is damaged, an error statement is printed
+ * out.
+ *
+ * checkpoint:	a pointer to the checkpoint state
+ * policy:		a pointer to the scheduling policy
+ * ready:		a pointer to the (empty) Ready state of the policy
+ * arrivals:	a pointer to the stream of arriving processes, which must hold the whole input
+ * snapshot:	a pointer to where the state of the simulation loop is stored
+ * results:		a pointer to where the running totals are stored
+ *
+ * Returns: 0 on success, -1 if an error occurs
+ */
+int load_checkpoint(struct checkpointer* checkpoint, const struct policy* policy, void* ready, struct arrival_stream* arrivals, struct sim_snapshot* snapshot, struct sim_results* results) {
+	struct process_table* table = arrivals->table;
+	FILE* checkpoint_file = checkpoint->resume_file;
+	checkpoint->resume_file = NULL;
+	if (checkpoint->resume_processes != table->size || checkpoint->resume_hash != hash_input(table)) {
+		printf("ERROR: The checkpoint was taken with another input!\n");
+		fclose(checkpoint_file);
+		return -1;
+	}
+
+	int result = read_sim_state(checkpoint_file, policy, ready, arrivals, snapshot, results);
+	fclose(checkpoint_file);
+	if (result != 0 || checkpoint->first_row > arrivals->next) {
+		printf("ERROR: The checkpoint is damaged!\n");
+		return -1;
+	}
+
+	/* The processes before the first row of the checkpoint have completed, which their remaining times show
+	 * again, so that the next checkpoint does not look at them. */
+	for (int i = 0; i < checkpoint->first_row; i++) {
+		arrivals->table->remaining_time[i] = 0;
+	}
+	return 0;
+}
+
+/*
+ * Release the checkpoint a simulation was to resume from, if it was never read.
+ *
+ * checkpoint:	a pointer to the checkpoint state
+ */
+void close_checkpointer(struct checkpointer* checkpoint) {
+	if (checkpoint->resume_file != NULL) {
+		fclose(checkpoint->resume_file);
+		checkpoint->resume_file = NULL;
+	}
+}
+
+/*
+ * Write the processes of a queue to a checkpoint, from the front to the rear.
+ *
+ * current_queue:	a pointer to the queue
+ * checkpoint_file:	the checkpoint file
+ */
+void save_queue(const struct queue* current_queue, FILE* checkpoint_file) {
+	fwrite(&current_queue->size, sizeof(int), 1, checkpoint_file);
+	for (struct node* current_node = current_queue->head; current_node != NULL; current_node = current_node->next) {
+		fwrite(&current_node->data, sizeof(int), 1, checkpoint_file);
+	}
+}
+
+/*
+ * Read the processes written by save_queue() from a checkpoint and add them to the end of a queue.
+ *
+ * current_queue:	a pointer to the queue
+ * table:			a pointer to the table the processes are in
+ * checkpoint_file:	the checkpoint file
+ *
+ * Returns: 0 on success, -1 if the checkpoint is damaged
+ */
+int load_queue(struct queue* current_queue, const struct process_table* table, FILE* checkpoint_file) {
+	int size;
+	if (fread(&size, sizeof(int), 1, checkpoint_file) != 1 || size < 0 || size > table->size) {
+		return -1;
+	}
+	for (int i = 0; i < size; i++) {
+		int process;
+		if (read_checkpoint_process(checkpoint_file, table, &process) != 0) {
+			return -1;
+		}
+		enqueue(current_queue, process);
+	}
+	return 0;
+}
+
+/*
+ * Write a priority queue to a checkpoint exactly as it is laid out, including the order given to the next
+ * added process, so that ties are broken the same way after resuming. Processes that are not in place yet are
+ * moved into place first.
+ *
+ * current_heap:	a pointer to the priority queue
+ * checkpoint_file:	the checkpoint file
+ */
+void save_heap(struct heap* current_heap, FILE* checkpoint_file) {
+	if (current_heap->num_unsorted > 0) {
+		heap_fix(current_heap);
+	}
+	fwrite(&current_heap->size, sizeof(int), 1, checkpoint_file);
+	fwrite(&current_heap->next_order, sizeof(long), 1, checkpoint_file);
+	fwrite(current_heap->entries, sizeof(struct heap_entry), current_heap->size, checkpoint_file);
+}
+
+/*
+ * Read a priority queue written by save_heap() from a checkpoint into an empty priority queue.
+ *
+ * current_heap:	a pointer to the empty priority queue
+ * table:			a pointer to the table the processes are in
+ * checkpoint_file:	the checkpoint file
+ *
+ * Returns: 0 on success, -1 if the checkpoint is damaged
+ */
+int load_heap(struct heap* current_heap, const struct process_table* table, FILE* checkpoint_file) {
+	int size;
+	long next_order;
+	if (fread(&size, sizeof(int), 1, checkpoint_file) != 1 || size < 0 || size > table->size || fread(&next_order, sizeof(long), 1, checkpoint_file) != 1) {
+		return -1;
+	}
+	if (size > current_heap->capacity) {
+		current_heap->entries = (struct heap_entry*) arena_grow(current_heap->pool, current_heap->entries, current_heap->capacity * sizeof(struct heap_entry), size * sizeof(struct heap_entry));
+		current_heap->capacity = size;
+	}
+	if (fread(current_heap->entries, sizeof(struct heap_entry), size, checkpoint_file) != (size_t) size) {
+		return -1;
+	}
+	for (int i = 0; i < size; i++) {
+		if (current_heap->entries[i].data < 0 || current_heap->entries[i].data >= table->size) {
+			return -1;
+		}
+	}
+	current_heap->size = size;
+	current_heap->next_order = next_order;
+	return 0;
+}
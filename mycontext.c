@@ -0,0 +1,222 @@
+/**
+ * Implementation of simulation contexts, through which other programs use the scheduler as a library
+ * (libmydispatcher.a) instead of running the executable. A context holds a trace of processes loaded from
+ * memory and simulates any policy over it as often as needed, handing the results back as structures. All
+ * memory of a context is taken from two memory pools that are reset instead of freed between uses, so a
+ * context that is reused stops allocating memory once it has been used for its largest simulation. Nothing
+ * here prints anything or exits the program: errors, running out of memory included, are returned with a
+ * message kept in the context.
+ *
+ * Contexts share no state, so different contexts can be used from different threads at the same time. Every
+ * function of a context locks it, so a context used by several threads runs their simulations one at a time.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include "mydispatcher.h"
+
+/* Representation of a simulation context. */
+struct sim_context {
+	struct arena* trace_pool;		// the memory pool that owns the loaded trace
+	struct arena* run_pool;			// the memory pool that owns the state and results of the last simulation
+	struct process_table* table;	// the loaded trace, or NULL if none is loaded
+	jmp_buf out_of_memory;			// where the memory pools jump to if malloc() fails
+	pthread_mutex_t lock;			// held while the context is in use
+	char error[INPUT_ERROR_MAX];	// the message of the last error
+};
+
+/*
+ * Create a new simulation context with no trace loaded.
+ *
+ * Returns: a pointer to the created context, or NULL if there is not enough memory
+ */
+struct sim_context* create_sim_context() {
+	struct sim_context* context = (struct sim_context*) malloc(sizeof(struct sim_context));
+	if (context == NULL) {
+		return NULL;
+	}
+	context->trace_pool = create_arena();
+	context->run_pool = create_arena();
+	context->trace_pool->out_of_memory = &context->out_of_memory;
+	context->run_pool->out_of_memory = &context->out_of_memory;
+	context->table = NULL;
+	pthread_mutex_init(&context->lock, NULL);
+	context->error[0] = '\0';
+	return context;
+}
+
+/*
+ * Set a simulation request to a single-CPU FCFS simulation with the default parameters, no percentiles and
+ * no results of single processes.
+ *
+ * request:	a pointer to the request to set
+ */
+void default_sim_request(struct sim_request* request) {
+	request->policy = "FCFS";
+	default_policy_params(&request->params);
+	request->num_cpus = 1;
+	request->queue_mode = QUEUE_GLOBAL;
+	request->percentiles = -1;
+	request->keep_processes = 0;
+}
+
+/*
+ * Load a trace of processes into a simulation context, replacing the trace loaded before (if any). The trace
+ * is in the format of an input file, one line of arrival time and service time per process, and is copied
+ * into the context, so it does not have to be kept afterwards.
+ *
+ * context:		a pointer to the context
+ * trace:		a pointer to the first byte of the trace
+ * trace_size:	the number of bytes of the trace
+ *
+ * Returns: 0 on success, -1 if the trace does not have the correct format or there is not enough memory (the
+ *			context has no trace loaded in that case, and sim_context_error() tells what went wrong)
+ */
+int sim_context_load(struct sim_context* context, const char* trace, size_t trace_size) {
+	pthread_mutex_lock(&context->lock);
+	reset_arena(context->trace_pool);
+	reset_arena(context->run_pool);
+	context->table = NULL;
+	int result = -1;
+	if (setjmp(context->out_of_memory) == 0) {
+		context->table = parse_input(trace, trace_size, "trace", context->trace_pool, context->error);
+		result = context->table != NULL ? 0 : -1;
+	} else {
+		/* The pool ran out of memory part of the way through, so whatever it holds is of no use. */
+		reset_arena(context->trace_pool);
+		context->table = NULL;
+		snprintf(context->error, INPUT_ERROR_MAX, "Out of memory!");
+	}
+	pthread_mutex_unlock(&context->lock);
+	return result;
+}
+
+/*
+ * Check the parameters of a simulation request, which are taken from a program instead of the command line.
+ *
+ * request:	a pointer to the request
+ *
+ * Returns: 1 if they are valid, 0 otherwise
+ */
+static int valid_request(const struct sim_request* request) {
+	const struct policy_params* params = &request->params;
+	return params->quantum > 0 && params->num_levels >= 1 && params->num_levels <= 16 && params->boost_interval >= 0 && params->aging_interval >= 0
+		&& request->num_cpus >= 1 && request->queue_mode >= QUEUE_GLOBAL && request->queue_mode <= QUEUE_STEALING && request->percentiles >= -1
+		&& request->percentiles <= PERCENTILES_EXACT;
+}
+
+/*
+ * Simulate a scheduling policy over the trace of a simulation context, taking all memory from the pool of the
+ * context for simulations, which has been reset.
+ *
+ * context:	a pointer to the context
+ * policy:	a pointer to the scheduling policy
+ * request:	a pointer to the request, which has been checked
+ * report:	a pointer to where the results are stored
+ */
+static void simulate_in_context(struct sim_context* context, const struct policy* policy, const struct sim_request* request, struct sim_report* report) {
+	struct arena* pool = context->run_pool;
+	struct output_writer* output = open_output_writer(NULL, request->keep_processes ? OUTPUT_RECORDS : OUTPUT_NONE, 0, pool);
+	struct arrival_stream arrivals;
+	init_table_stream(&arrivals, copy_process_table(context->table, pool));
+	struct sim_results results;
+	results.latency = request->percentiles != -1 ? create_latency_stats(request->percentiles, pool) : NULL;
+	results.checkpoint = NULL;
+	results.what_if = NULL;
+	memset(report, 0, sizeof(struct sim_report));
+	if (request->num_cpus > 1) {
+		simulate_smp(policy, &request->params, request->num_cpus, request->queue_mode, &arrivals, output, pool, &results, &report->cpus);
+	} else {
+		simulate(policy, &request->params, &arrivals, output, pool, &results);
+	}
+
+	report->num_processes = results.num_processes;
+	report->num_events = results.num_events;
+	if (results.num_processes > 0) {
+		report->average_turnaround = sum_value(&results.sum_turnaround)/results.num_processes;
+		report->average_normalized_turnaround = sum_value(&results.sum_normalized_turnaround)/results.num_processes;
+		report->average_waiting = sum_value(&results.sum_waiting)/results.num_processes;
+	}
+	if (results.latency != NULL) {
+		summarize_latency(results.latency, &report->latency);
+	}
+	report->processes = output->records;
+}
+
+/*
+ * Simulate a scheduling policy over the trace loaded into a simulation context. The results of the simulation
+ * before (if any) are no longer valid afterwards.
+ *
+ * context:	a pointer to the context
+ * request:	a pointer to what the simulation should do
+ * report:	a pointer to where the results are stored
+ *
+ * Returns: 0 on success, -1 if no trace is loaded, the request is not valid or there is not enough memory
+ *			(sim_context_error() tells what went wrong in that case)
+ */
+int sim_context_run(struct sim_context* context, const struct sim_request* request, struct sim_report* report) {
+	pthread_mutex_lock(&context->lock);
+	const struct policy* policy = request->policy != NULL ? find_policy(request->policy) : NULL;
+	int result = -1;
+	if (context->table == NULL) {
+		snprintf(context->error, INPUT_ERROR_MAX, "No trace is loaded!");
+	} else if (policy == NULL) {
+		snprintf(context->error, INPUT_ERROR_MAX, "Unknown scheduling policy \"%s\"!", request->policy != NULL ? request->policy : "");
+	} else if (!valid_request(request)) {
+		snprintf(context->error, INPUT_ERROR_MAX, "Invalid parameters!");
+	} else {
+		reset_arena(context->run_pool);
+		if (setjmp(context->out_of_memory) == 0) {
+			simulate_in_context(context, policy, request, report);
+			result = 0;
+		} else {
+			reset_arena(context->run_pool);
+			snprintf(context->error, INPUT_ERROR_MAX, "Out of memory!");
+		}
+	}
+	pthread_mutex_unlock(&context->lock);
+	return result;
+}
+
+/*
+ * Forget the trace and the results of a simulation context, as if it had just been created, but keep its
+ * memory so that it can be reused without allocating it again.
+ *
+ * context:	a pointer to the context
+ */
+void sim_context_reset(struct sim_context* context) {
+	pthread_mutex_lock(&context->lock);
+	reset_arena(context->trace_pool);
+	reset_arena(context->run_pool);
+	context->table = NULL;
+	context->error[0] = '\0';
+	pthread_mutex_unlock(&context->lock);
+}
+
+/*
+ * Get the message of the last error of a simulation context, such as a malformed line of a trace.
+ *
+ * context:	a pointer to the context
+ *
+ * Returns: the message, or an empty string if no error has occurred
+ */
+const char* sim_context_error(struct sim_context* context) {
+	return context->error;
+}
+
+/*
+ * Deallocate a simulation context together with its trace, its results and all of its memory.
+ *
+ * context:	a pointer to the context to be deallocated
+ */
+void destroy_sim_context(struct sim_context* context) {
+	pthread_mutex_destroy(&context->lock);
+	destroy_arena(context->trace_pool);
+	destroy_arena(context->run_pool);
+	free(context);
+}
@@ -1,14 +1,22 @@
 /**
- * A program that illustrates two CPU scheduling policies, Shortest Process Next (SPN) and Shortest Remaining Time (SRT).
+ * A program that illustrates CPU scheduling policies: First-Come-First-Served (FCFS), Round Robin (RR), Shortest
+ * Process Next (SPN), Shortest Remaining Time (SRT), Highest Response Ratio Next (HRRN) and a multilevel feedback
+ * queue (MLFQ). Besides simulating one policy over an input, it can compare several policies at once, sweep their
+ * parameters, simulate a batch of traces, answer what-if queries about edited inputs, generate synthetic inputs
+ * and check itself against known schedules.
  *
  * - Author: Hieu Tran
  * - Course: COMP 354: Operating Systems
  * - Instructor: Shikha Mittal
  * - Date created: 05/15/2020
- * - Last updated: 05/28/2020
+ * - Last updated: 10/17/2026
  */
 
+#include <errno.h>
+#include <limits.h>
 #include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
 #include "mydispatcher.h"
 
 /*
@@ -18,49 +26,904 @@
 void print_error_and_instructions() {
 	printf("ERROR: Invalid arguments!\n");
 	printf("There should be 2 arguments:\n");
-	printf("- \"input.dat\"\n");
-	printf("- Either \"SPN\" or \"SRT\"\n");
+	printf("- The input file (such as \"input.dat\"), or \"-\" to read from stdin\n");
+	printf("- The scheduling policy: \"FCFS\", \"RR\", \"SPN\", \"SRT\", \"HRRN\" or \"MLFQ\"; several policies separated by\n");
+	printf("  commas, or \"ALL\", to run them in parallel and write the results to \"output_<POLICY>.dat\"\n");
+	printf("Optionally followed by:\n");
+	printf("- \"--stream\" to read processes only when they arrive, instead of reading the whole input first (one policy only)\n");
+	printf("- \"--parse-stats\" to print out how long reading the input took (not with \"--stream\")\n");
+	printf("- \"--binary\" to write a binary event log to \"output.bin\" instead of \"output.dat\"\n");
+	printf("- \"--writer-thread\" to write the output from a separate thread\n");
+	printf("- \"--quantum N\" to set the time quantum of RR and of the top level of MLFQ (default 1)\n");
+	printf("- \"--levels N\" to set the number of priority levels of MLFQ (1 to 16, default 3)\n");
+	printf("- \"--boost N\" to move every MLFQ process back to the top level every N time units (default 0, never)\n");
+	printf("- \"--aging N\" to make SPN and SRT count a process as one time unit shorter for every N time units it has waited, so\n");
+	printf("  that long processes are not starved (default 0, no aging)\n");
+	printf("- \"--cpus N\" to simulate N CPUs (default 1), printing out the utilization and migrations of every CPU\n");
+	printf("- \"--queue MODE\" to choose how the CPUs share the processes: \"global\" (one shared Ready queue, default),\n");
+	printf("  \"balanced\" (a Ready queue per CPU, arrivals join the less loaded of two) or \"stealing\" (a Ready queue\n");
+	printf("  per CPU, idle CPUs steal from the others)\n");
+	printf("- \"--metrics FORMAT\" to print out the counters of the simulation on stderr, where FORMAT is \"json\" or \"csv\"\n");
+	printf("  (one policy, only in builds made with \"make METRICS=1\")\n");
+	printf("- \"--percentiles MODE\" to also print out the p50, p95, p99, p99.9 and maximum of the waiting and turnaround\n");
+	printf("  times and the longest wait in the Ready state, where MODE is \"hdr\" (a histogram of fixed size, within 1%%)\n");
+	printf("  or \"exact\" (keeps every value)\n");
+	printf("- \"--trace FILE\" to also write a timeline of every run, arrival and idle interval to FILE in the Chrome\n");
+	printf("  trace-event JSON format, for chrome://tracing or Perfetto (one policy)\n");
+	printf("- \"--checkpoint FILE\" to write the whole state of the simulation to FILE every 5 seconds (or every N seconds\n");
+	printf("  with \"--checkpoint-every N\"), and \"--resume FILE\" to carry on from such a checkpoint with the same input, policy\n");
+	printf("  and options (one policy and one CPU, not with \"--stream\", \"--bench\", \"--trace\" or \"--percentiles\")\n");
+	printf("- \"--bench\" to print out how long parsing, scheduling and output took, and the peak memory use (one policy,\n");
+	printf("  not with \"--stream\")\n");
+	printf("- \"--what-if FILE\" to answer the queries in FILE (or \"-\" for stdin), one per line, about how the averages\n");
+	printf("  change if some processes are edited, without simulating the whole input again; a query is a list of edits\n");
+	printf("  such as \"4:service=2 9:arrival=130\" (one policy and one CPU, with no other option but the parameters of\n");
+	printf("  the policy)\n");
+	printf("To run a parameter sweep, the policy is replaced by one or more of:\n");
+	printf("- \"--sweep GRID\", where GRID is a policy followed by any number of \":NAME=VALUES\", NAME is \"quantum\", \"levels\",\n");
+	printf("  \"boost\" or \"aging\", and VALUES is a comma-separated list of values \"A\", ranges \"A-B\" or ranges with a step \"A-B/S\";\n");
+	printf("  for example \"RR:quantum=1-20\", \"MLFQ:levels=2-4:boost=0,50,100\" or \"SRT:aging=0,10,100\"\n");
+	printf("  optionally followed by \"--threads N\" (default: the number of processors) and \"--csv FILE\" (default \"sweep.csv\")\n");
+	printf("To simulate a batch of traces, the arguments should instead be \"--batch SOURCE POLICY\", where SOURCE is a\n");
+	printf("directory whose files are all traces or a file listing the paths of the traces, one per line, optionally\n");
+	printf("followed by the parameters of the policy, \"--cpus N\", \"--queue MODE\", \"--binary\", \"--threads N\" (default:\n");
+	printf("the number of processors), \"--output-dir DIR\" where the output of every trace is written (default\n");
+	printf("\"batch_output\") and \"--csv FILE\" where the averages of every trace are written (default \"batch.csv\")\n");
+	printf("To generate a synthetic input file, the arguments should instead be \"--generate N FILE\" to write N processes\n");
+	printf("to FILE, optionally followed by:\n");
+	printf("- \"--seed N\" to set the seed of the random number generator (default 1)\n");
+	printf("- \"--arrivals PROCESS\" where PROCESS is \"poisson\" (default) or \"bursty\"\n");
+	printf("- \"--service DISTRIBUTION\" where DISTRIBUTION is \"exponential\" (default), \"uniform\" or \"pareto\"\n");
+	printf("- \"--mean-interarrival N\" and \"--mean-service N\" to set the mean time between arrivals (default 4) and the\n");
+	printf("  mean service time (default 3)\n");
+	printf("To check the simulator, the arguments should instead be \"--verify N\" to compare every policy against its\n");
+	printf("known output for the sample input and against other ways of running the same simulation on N random traces,\n");
+	printf("optionally followed by \"--seed N\" (default 1), \"--min-rate N\" to fail if any policy schedules fewer than\n");
+	printf("N events per second (default 1000000, or 0 not to time the policies) and \"--golden DIR\" to read the sample\n");
+	printf("input and the known outputs from DIR (default \"golden\")\n");
+	printf("To convert a binary event log to the text format, there should instead be 3 arguments:\n");
+	printf("- \"--convert\", the binary event log and the text file to write\n");
+}
+
+/*
+ * Read a non-negative integer argument.
+ *
+ * argument:	the argument to read
+ * value:		a pointer to where the integer is stored
+ *
+ * Returns: 1 if the argument is a non-negative integer that fits in an int, 0 otherwise
+ */
+int parse_int_argument(const char* argument, int* value) {
+	char* end;
+	long result = strtol(argument, &end, 10);
+	if (*argument < '0' || *argument > '9' || *end != '\0' || result > INT_MAX) {
+		return 0;
+	}
+	*value = (int) result;
+	return 1;
+}
+
+/*
+ * Read a non-negative integer argument that may need 64 bits, such as a time.
+ *
+ * argument:	the argument to read
+ * value:		a pointer to where the integer is stored
+ *
+ * Returns: 1 if the argument is a non-negative integer that fits in a long, 0 otherwise
+ */
+int parse_long_argument(const char* argument, long* value) {
+	char* end;
+	errno = 0;
+	long result = strtol(argument, &end, 10);
+	if (*argument < '0' || *argument > '9' || *end != '\0' || errno == ERANGE) {
+		return 0;
+	}
+	*value = result;
+	return 1;
+}
+
+/*
+ * Read an argument that is one of a list of names.
+ *
+ * argument:	the argument to read
+ * names:		an array of the names, in the order of the values they stand for
+ * count:		the number of names
+ *
+ * Returns: the index of the argument in the names, or -1 if it is none of them
+ */
+int parse_name_argument(const char* argument, const char* const* names, int count) {
+	for (int i = 0; i < count; i++) {
+		if (strcmp(argument, names[i]) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* The largest number of parameter grids in one parameter sweep. */
+#define MAX_SWEEP_GRIDS 64
+
+/* Representation of the optional arguments of a run. */
+struct run_options {
+	int print_parse_stats;			// whether to print out how long reading the input took
+	int streaming;					// whether to read processes only when they arrive
+	int output_format;				// the format of the output file
+	int writer_thread;				// whether to write the output from a separate thread
+	int bench;						// whether to time parsing, scheduling and output separately
+	int num_cpus;					// the number of CPUs to simulate
+	int queue_mode;					// how the CPUs share the processes
+	int metrics_format;				// the format of the metrics report, or -1 for no report
+	int percentiles;				// how percentiles are worked out, or -1 to print out the averages only
+	struct policy_params params;	// the parameters of the scheduling policies
+	const char* sweep_grids[MAX_SWEEP_GRIDS];	// the parameter grids of a parameter sweep
+	int num_sweep_grids;			// the number of parameter grids
+	int num_threads;				// the number of worker threads of a parameter sweep
+	const char* csv_path;			// the path of the CSV file written by a parameter sweep or a batch, or NULL
+									// for the default
+	const char* output_dir;			// the directory the output of every trace of a batch is written to, or NULL
+									// for the default
+	const char* trace_path;			// the path of the timeline to write, or NULL for none
+	const char* checkpoint_path;	// the path of the checkpoint file to write, or NULL for none
+	int checkpoint_interval;		// the number of seconds between checkpoints
+	const char* resume_path;		// the path of the checkpoint to resume from, or NULL to start afresh
+	const char* what_if_path;		// the path of the what-if queries to answer, or NULL for none
+};
+
+/* The largest number of policies that can be compared in one run. */
+#define MAX_POLICIES 16
+
+/*
+ * Read the list of scheduling policies to run, which is either a single policy name, several names separated
+ * by commas, or "ALL" for every available policy.
+ *
+ * argument:	the argument to read
+ * policies:	an array of at least MAX_POLICIES elements where the policies are stored
+ *
+ * Returns: the number of policies, or 0 if the list is not valid
+ */
+int parse_policy_list(const char* argument, const struct policy** policies) {
+	if (strcmp(argument, "ALL") == 0) {
+		const char* all_names[] = { "FCFS", "RR", "SPN", "SRT", "HRRN", "MLFQ" };
+		for (int i = 0; i < 6; i++) {
+			policies[i] = find_policy(all_names[i]);
+		}
+		return 6;
+	}
+
+	int num_policies = 0;
+	const char* name = argument;
+	while (1) {
+		/* Copy the next name into a buffer, since find_policy() needs it on its own. */
+		char buffer[32];
+		size_t length = strcspn(name, ",");
+		if (length == 0 || length >= sizeof(buffer) || num_policies == MAX_POLICIES) {
+			return 0;
+		}
+		memcpy(buffer, name, length);
+		buffer[length] = '\0';
+		policies[num_policies] = find_policy(buffer);
+		if (policies[num_policies] == NULL) {
+			return 0;
+		}
+		num_policies++;
+		if (name[length] == '\0') {
+			return num_policies;
+		}
+		name += length + 1;
+	}
+}
+
+/*
+ * Get a table of processes from the whole input. If the input cannot be read or is malformed, an error
+ * statement is printed out and the program exits.
+ *
+ * input_path:	the path of the input, or "-" for stdin
+ * pool:		a pointer to the memory pool that owns the table
+ * options:		a pointer to the optional arguments of the run
+ * parse_stats:	a pointer to where the size of the input and the time spent reading it are stored
+ *
+ * Returns: a pointer to the table of processes
+ */
+struct process_table* load_input(const char* input_path, struct arena* pool, const struct run_options* options, struct input_stats* parse_stats) {
+	struct process_table* process_table = read_input(input_path, pool, parse_stats);
+	if (process_table == NULL) {
+		exit(1);
+	}
+	if (options->print_parse_stats) {
+		/* Report the parsing throughput on stderr, so that the results on stdout are unchanged. */
+		fprintf(stderr, "Parsed %ld bytes (%d processes) in %f seconds: %f MB/s\n", parse_stats->bytes, process_table->size, parse_stats->seconds, parse_stats->bytes / 1e6 / parse_stats->seconds);
+	}
+	return process_table;
+}
+
+/*
+ * Simulate a scheduling policy on one CPU, or on several CPUs if the run asks for it.
+ *
+ * policy:		a pointer to the scheduling policy
+ * options:		a pointer to the optional arguments of the run
+ * arrivals:	a pointer to the stream of arriving processes
+ * output:		a pointer to the output writer to write results to
+ * pool:		a pointer to the memory pool used for the state of the simulation
+ * results:		a pointer to where the totals needed for the averages are stored
+ * smp_results:	a pointer to where the statistics of every CPU are stored (unused for one CPU)
+ */
+void run_simulation(const struct policy* policy, const struct run_options* options, struct arrival_stream* arrivals, struct output_writer* output, struct arena* pool, struct sim_results* results, struct smp_results* smp_results) {
+	if (options->num_cpus > 1) {
+		simulate_smp(policy, &options->params, options->num_cpus, options->queue_mode, arrivals, output, pool, results, smp_results);
+	} else {
+		simulate(policy, &options->params, arrivals, output, pool, results);
+	}
+}
+
+/*
+ * Simulate a scheduling policy over a table of processes without writing any output, to time the scheduling
+ * alone. The table is left unchanged.
+ *
+ * policy:		a pointer to the scheduling policy
+ * options:		a pointer to the optional arguments of the run
+ * table:		a pointer to the table of processes
+ *
+ * Returns: the time the simulation took in seconds
+ */
+double time_scheduling(const struct policy* policy, const struct run_options* options, const struct process_table* table) {
+	struct arena* pool = create_arena();
+	struct output_writer* output = open_output_writer(NULL, OUTPUT_NONE, 0, pool);
+	struct arrival_stream arrivals;
+	init_table_stream(&arrivals, copy_process_table(table, pool));
+	struct sim_results results;
+	results.latency = NULL;
+	results.checkpoint = NULL;
+	results.what_if = NULL;
+	struct smp_results smp_results;
+	double start_seconds = current_seconds();
+	run_simulation(policy, options, &arrivals, output, pool, &results, &smp_results);
+	double seconds = current_seconds() - start_seconds;
+	destroy_arena(pool);
+	return seconds;
+}
+
+/*
+ * Print out the results of a benchmark of a single policy on stderr, so that the results on stdout are
+ * unchanged: the time spent parsing, scheduling and writing the output, the number of events (completions and
+ * preemptions) per second of scheduling and the peak memory use of the program.
+ *
+ * policy:				a pointer to the scheduling policy
+ * num_processes:		the number of processes in the input
+ * parse_seconds:		the time spent reading the input
+ * schedule_seconds:	the time spent simulating the policy without writing any output
+ * total_seconds:		the time spent simulating the policy and writing the output
+ * num_events:			the number of events of the simulation
+ */
+void print_benchmark(const struct policy* policy, int num_processes, double parse_seconds, double schedule_seconds, double total_seconds, long num_events) {
+	/* The output time is whatever the full run took on top of scheduling alone. ru_maxrss is in kilobytes on
+	 * Linux. */
+	double output_seconds = total_seconds > schedule_seconds ? total_seconds - schedule_seconds : 0;
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	fprintf(stderr, "%-5s %10d processes: parse %9.6f s, schedule %9.6f s, output %9.6f s, %12.0f events/s, peak RSS %ld KiB\n", policy->name, num_processes, parse_seconds, schedule_seconds, output_seconds, schedule_seconds > 0 ? num_events / schedule_seconds : 0, usage.ru_maxrss);
+}
+
+/*
+ * Simulate a single scheduling policy, writing the results to "output.dat" (or "output.bin") and printing
+ * out the averages.
+ *
+ * input_path:	the path of the input, or "-" for stdin
+ * policy:		a pointer to the scheduling policy
+ * options:		a pointer to the optional arguments of the run
+ *
+ * Returns: 0 on success, 1 if an error occurs
+ */
+int run_policy(const char* input_path, const struct policy* policy, const struct run_options* options) {
+	/* Create the memory pool that owns all memory of this run, then open/create the output file for
+	 * writing. */
+	struct arena* pool = create_arena();
+	const char* output_path = options->output_format == OUTPUT_BINARY ? "output.bin" : "output.dat";
+	struct checkpointer* checkpoint = NULL;
+	if (options->checkpoint_path != NULL || options->resume_path != NULL) {
+		checkpoint = create_checkpointer(options->checkpoint_path, options->checkpoint_interval, pool);
+		if (options->resume_path != NULL && open_checkpoint(checkpoint, options->resume_path, policy, &options->params, options->output_format) != 0) {
+			return 1;
+		}
+	}
+	struct output_writer* output;
+	if (options->resume_path != NULL) {
+		/* When resuming, keep the output written up to the checkpoint and carry on after it. */
+		output = reopen_output_writer(output_path, options->output_format, options->writer_thread, checkpoint->output_size, pool);
+		if (output == NULL) {
+			printf("ERROR: Cannot carry on writing file \"%s\", which is missing or shorter than when the checkpoint was taken!\n", output_path);
+			close_checkpointer(checkpoint);
+			return 1;
+		}
+	} else {
+		output = open_output_writer(output_path, options->output_format, options->writer_thread, pool);
+		if (output == NULL) {
+			/* If a problem occurs with opening/creating the output file, print out an error statement. */
+			printf("ERROR: Cannot open/create file \"%s\"\n", output_path);
+			return 1;
+		}
+	}
+	if (options->trace_path != NULL) {
+		/* Every event written to the output is also written to the timeline as the simulation goes. */
+		output->trace = open_output_writer(options->trace_path, OUTPUT_TRACE, options->writer_thread, pool);
+		if (output->trace == NULL) {
+			printf("ERROR: Cannot open/create file \"%s\"\n", options->trace_path);
+			close_output_writer(output);
+			return 1;
+		}
+	}
+
+	struct arrival_stream arrivals;
+	struct input_stats parse_stats;
+	struct input_reader* reader = NULL;
+	if (options->streaming) {
+		/* In streaming mode, processes are read from the input only when the scheduler reaches their arrival
+		 * time, into a table that only holds the processes alive at once. */
+		reader = open_input_reader(input_path, pool);
+		if (reader == NULL) {
+			return 1;
+		}
+		init_reader_stream(&arrivals, create_process_table(pool), reader);
+	} else {
+		/* Otherwise, get a table of processes from the whole input first. */
+		init_table_stream(&arrivals, load_input(input_path, pool, options, &parse_stats));
+	}
+
+	/* When benchmarking, first time the scheduling alone on a copy of the table, so that the time spent on
+	 * the output can be told apart from it. */
+	double schedule_seconds = 0;
+	if (options->bench) {
+		schedule_seconds = time_scheduling(policy, options, arrivals.table);
+	}
+
+	/* Run the simulation with the chosen scheduling policy and print out the averages. */
+	reset_metrics();
+	double start_seconds = current_seconds();
+	struct sim_results results;
+	results.latency = options->percentiles != -1 ? create_latency_stats(options->percentiles, pool) : NULL;
+	results.checkpoint = checkpoint;
+	results.what_if = NULL;
+	struct smp_results smp_results;
+	run_simulation(policy, options, &arrivals, output, pool, &results, &smp_results);
+	int checkpoint_error = 0;
+	if (checkpoint != NULL) {
+		/* If a checkpoint could not be written or read, an error statement has already been printed out. */
+		close_checkpointer(checkpoint);
+		checkpoint_error = checkpoint->error;
+	}
+	print_averages(&results);
+	if (options->num_cpus > 1) {
+		print_cpu_stats(&smp_results);
+	}
+	if (results.latency != NULL) {
+		struct latency_summary summary;
+		summarize_latency(results.latency, &summary);
+		print_latency_summary(&summary);
+	}
+
+	/* Write out the rest of the output and close the output file (and the timeline), then release all memory
+	 * of this run at once. */
+	int output_error = close_output_writer(output) != 0;
+	if (output_error) {
+		printf("ERROR: Cannot write file \"%s\"\n", output_path);
+	}
+	if (output->trace != NULL && close_output_writer(output->trace) != 0) {
+		printf("ERROR: Cannot write file \"%s\"\n", options->trace_path);
+		output_error = 1;
+	}
+	double total_seconds = current_seconds() - start_seconds;
+	if (options->bench) {
+		print_benchmark(policy, arrivals.table->size, parse_stats.seconds, schedule_seconds, total_seconds, results.num_events);
+	}
+	if (options->metrics_format != -1) {
+		struct run_report report = { policy->name, options->num_cpus, results.num_processes, results.num_events, options->streaming ? 0 : parse_stats.seconds, total_seconds, pool->num_allocations, pool->allocated_bytes };
+		write_metrics_report(stderr, options->metrics_format, &report);
+	}
+	int input_error = 0;
+	if (reader != NULL) {
+		/* If the input turned out to be malformed while streaming, the reader has already printed out an
+		 * error statement. */
+		input_error = reader->error;
+		close_input_reader(reader);
+	}
+	destroy_arena(pool);
+	return input_error || output_error || checkpoint_error;
+}
+
+/*
+ * Simulate several scheduling policies in parallel over the same input, which is read only once. The results
+ * of each policy are written to a file of its own, and a table comparing the averages is printed out.
+ *
+ * input_path:		the path of the input, or "-" for stdin
+ * policies:		an array of the scheduling policies
+ * num_policies:	the number of scheduling policies
+ * options:			a pointer to the optional arguments of the run
+ *
+ * Returns: 0 on success, 1 if an error occurs
+ */
+int compare_policies(const char* input_path, const struct policy** policies, int num_policies, const struct run_options* options) {
+	struct arena* pool = create_arena();
+	struct input_stats parse_stats;
+	struct process_table* process_table = load_input(input_path, pool, options, &parse_stats);
+
+	struct policy_run runs[MAX_POLICIES];
+	for (int i = 0; i < num_policies; i++) {
+		runs[i].policy = policies[i];
+		runs[i].params = &options->params;
+		runs[i].table = process_table;
+		runs[i].output_format = options->output_format;
+		runs[i].writer_thread = options->writer_thread;
+		runs[i].percentiles = options->percentiles;
+	}
+	int result = run_policies_in_parallel(runs, num_policies);
+	print_comparison(runs, num_policies);
+
+	destroy_arena(pool);
+	return result != 0;
+}
+
+/*
+ * Run a parameter sweep over the same input, which is read only once, and write the averages of every
+ * configuration to a CSV file.
+ *
+ * input_path:	the path of the input, or "-" for stdin
+ * options:		a pointer to the optional arguments of the run, which hold the parameter grids
+ *
+ * Returns: 0 on success, 1 if an error occurs
+ */
+int sweep_parameters(const char* input_path, const struct run_options* options) {
+	/* Expand the grids first, so that a mistake in them is found before the input is read. */
+	struct sweep_point* points = NULL;
+	int num_points = 0;
+	int capacity = 0;
+	for (int i = 0; i < options->num_sweep_grids; i++) {
+		num_points = expand_sweep_grid(options->sweep_grids[i], &options->params, &points, num_points, &capacity);
+		if (num_points < 0) {
+			printf("ERROR: Invalid parameter grid \"%s\"!\n", options->sweep_grids[i]);
+			free(points);
+			return 1;
+		}
+	}
+
+	struct arena* pool = create_arena();
+	struct input_stats parse_stats;
+	struct process_table* process_table = load_input(input_path, pool, options, &parse_stats);
+	for (int i = 0; i < num_points; i++) {
+		points[i].table = process_table;
+	}
+	int num_threads = options->num_threads > 0 ? options->num_threads : num_processors();
+	const char* csv_path = options->csv_path != NULL ? options->csv_path : "sweep.csv";
+	int result = run_sweep(points, num_points, num_threads, csv_path);
+	if (result == 0) {
+		printf("Simulated %d configurations on %d threads, written to \"%s\"\n", num_points, num_threads, csv_path);
+	}
+
+	destroy_arena(pool);
+	free(points);
+	return result != 0;
+}
+
+/*
+ * Simulate a scheduling policy over a batch of traces, writing the results of every trace to a file of its
+ * own and the averages of every trace to a CSV file, then print out the averages over all processes of all
+ * traces.
+ *
+ * source:		the directory of the traces, or a file listing them
+ * policy:		a pointer to the scheduling policy
+ * options:		a pointer to the optional arguments of the run
+ *
+ * Returns: 0 on success, 1 if an error occurs
+ */
+int simulate_batch(const char* source, const struct policy* policy, const struct run_options* options) {
+	const char* output_dir = options->output_dir != NULL ? options->output_dir : "batch_output";
+	const char* csv_path = options->csv_path != NULL ? options->csv_path : "batch.csv";
+	struct arena* pool = create_arena();
+	struct batch_settings settings = { policy, &options->params, options->num_cpus, options->queue_mode, options->output_format };
+	struct batch_trace* traces;
+	int num_traces = collect_batch_traces(source, output_dir, &settings, pool, &traces);
+	if (num_traces < 0) {
+		destroy_arena(pool);
+		return 1;
+	}
+	if (mkdir(output_dir, 0777) != 0 && errno != EEXIST) {
+		printf("ERROR: Cannot create directory \"%s\"\n", output_dir);
+		destroy_arena(pool);
+		return 1;
+	}
+
+	int num_threads = options->num_threads > 0 ? options->num_threads : num_processors();
+	double start_seconds = current_seconds();
+	int result = run_batch(traces, num_traces, num_threads, csv_path);
+	double seconds = current_seconds() - start_seconds;
+
+	/* The averages over all traces weigh every process the same, however large its trace. The total number
+	 * of processes may not fit in an int. */
+	long num_processes = 0;
+	struct compensated_sum sum_turnaround = { 0, 0 };
+	struct compensated_sum sum_normalized_turnaround = { 0, 0 };
+	struct compensated_sum sum_waiting = { 0, 0 };
+	int num_simulated = 0;
+	for (int i = 0; i < num_traces; i++) {
+		if (!traces[i].error) {
+			num_simulated++;
+			num_processes += traces[i].results.num_processes;
+			add_to_sum(&sum_turnaround, sum_value(&traces[i].results.sum_turnaround));
+			add_to_sum(&sum_normalized_turnaround, sum_value(&traces[i].results.sum_normalized_turnaround));
+			add_to_sum(&sum_waiting, sum_value(&traces[i].results.sum_waiting));
+		}
+	}
+	if (result >= 0) {
+		printf("Simulated %d of %d traces (%ld processes) on %d threads in %f seconds, written to \"%s\" and \"%s\"\n", num_simulated, num_traces, num_processes, num_threads, seconds, output_dir, csv_path);
+	}
+	if (num_processes > 0) {
+		printf("Average turnaround time = %f\n", sum_value(&sum_turnaround)/num_processes);
+		printf("Average normalized turnaround time = %f\n", sum_value(&sum_normalized_turnaround)/num_processes);
+		printf("Average waiting time = %f\n", sum_value(&sum_waiting)/num_processes);
+	}
+
+	destroy_arena(pool);
+	return result != 0;
+}
+
+/*
+ * Answer what-if queries about a scheduling policy over an input: simulate the policy over the input once,
+ * then, for every query, print out the averages as if the input had been edited as the query says. A query
+ * that is not valid is reported and skipped.
+ *
+ * input_path:	the path of the input, or "-" for stdin
+ * policy:		a pointer to the scheduling policy
+ * options:		a pointer to the optional arguments of the run, which hold the path of the queries
+ *
+ * Returns: 0 on success, 1 if an error occurs
+ */
+int answer_queries(const char* input_path, const struct policy* policy, const struct run_options* options) {
+	FILE* query_file = stdin;
+	if (strcmp(options->what_if_path, "-") == 0) {
+		if (strcmp(input_path, "-") == 0) {
+			printf("ERROR: The input and the queries cannot both be read from stdin!\n");
+			return 1;
+		}
+	} else {
+		query_file = fopen(options->what_if_path, "r");
+		if (query_file == NULL) {
+			printf("ERROR: Cannot open file \"%s\"\n", options->what_if_path);
+			return 1;
+		}
+	}
+
+	struct arena* pool = create_arena();
+	struct input_stats parse_stats;
+	struct process_table* process_table = load_input(input_path, pool, options, &parse_stats);
+	double start_seconds = current_seconds();
+	struct what_if* what_if = create_what_if(policy, &options->params, process_table);
+	printf("Simulated the original schedule of %d processes in %f seconds, keeping %d snapshots\n", process_table->size, current_seconds() - start_seconds, what_if->num_snapshots);
+	print_averages(&what_if->original_results);
+
+	/* Answer the queries one line at a time, skipping empty lines. */
+	int result = 0;
+	char* line = NULL;
+	size_t line_capacity = 0;
+	ssize_t length;
+	while ((length = getline(&line, &line_capacity, query_file)) != -1) {
+		while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+			line[--length] = '\0';
+		}
+		if (strspn(line, " \t,") == (size_t) length) {
+			continue;
+		}
+		struct what_if_answer answer;
+		char error[INPUT_ERROR_MAX];
+		start_seconds = current_seconds();
+		if (answer_what_if(what_if, line, &answer, error) != 0) {
+			printf("ERROR: %s\n", error);
+			result = 1;
+			continue;
+		}
+		double seconds = current_seconds() - start_seconds;
+		printf("\nWhat if %s: re-simulated %d processes from ", line, answer.num_simulated);
+		if (answer.resumed_time >= 0) {
+			printf("time %ld", answer.resumed_time);
+		} else {
+			printf("the start");
+		}
+		if (answer.stopped_time >= 0) {
+			printf(" to time %ld", answer.stopped_time);
+		} else {
+			printf(" to the end");
+		}
+		printf(" in %f seconds\n", seconds);
+		print_averages(&answer.results);
+		fflush(stdout);
+	}
+	if (ferror(query_file)) {
+		printf("ERROR: Cannot read file \"%s\"\n", options->what_if_path);
+		result = 1;
+	}
+	free(line);
+	if (query_file != stdin) {
+		fclose(query_file);
+	}
+	destroy_what_if(what_if);
+	destroy_arena(pool);
+	return result;
+}
+
+/*
+ * Write a synthetic input file, as described by the arguments after "--generate".
+ *
+ * argc:	the number of arguments
+ * argv:	the arguments, where argv[1] is "--generate"
+ *
+ * Returns: 0 on success, 1 if an error occurs
+ */
+int generate_input(int argc, char* argv[]) {
+	const char* const arrival_names[] = { "poisson", "bursty" };
+	const char* const service_names[] = { "exponential", "uniform", "pareto" };
+	struct workload_spec spec;
+	default_workload_spec(&spec);
+
+	int num_processes = 0;
+	int seed = 1;
+	int valid_arguments = argc >= 4 && parse_int_argument(argv[2], &num_processes);
+	for (int i = 4; valid_arguments && i < argc; i++) {
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			valid_arguments = parse_int_argument(argv[++i], &seed);
+		} else if (strcmp(argv[i], "--arrivals") == 0 && i + 1 < argc) {
+			spec.arrival_process = parse_name_argument(argv[++i], arrival_names, 2);
+			valid_arguments = spec.arrival_process != -1;
+		} else if (strcmp(argv[i], "--service") == 0 && i + 1 < argc) {
+			spec.service_distribution = parse_name_argument(argv[++i], service_names, 3);
+			valid_arguments = spec.service_distribution != -1;
+		} else if (strcmp(argv[i], "--mean-interarrival") == 0 && i + 1 < argc) {
+			valid_arguments = parse_long_argument(argv[++i], &spec.mean_interarrival);
+		} else if (strcmp(argv[i], "--mean-service") == 0 && i + 1 < argc) {
+			valid_arguments = parse_long_argument(argv[++i], &spec.mean_service) && spec.mean_service > 0;
+		} else {
+			valid_arguments = 0;
+		}
+	}
+	if (!valid_arguments) {
+		print_error_and_instructions();
+		return 1;
+	}
+
+	spec.num_processes = num_processes;
+	spec.seed = seed;
+	if (generate_workload(&spec, argv[3]) != 0) {
+		return 1;
+	}
+	printf("Generated %d processes, written to \"%s\"\n", num_processes, argv[3]);
+	return 0;
+}
+
+/*
+ * Check the simulator, as described by the arguments after "--verify".
+ *
+ * argc:	the number of arguments
+ * argv:	the arguments, where argv[1] is "--verify"
+ *
+ * Returns: 0 if every check passes, 1 otherwise
+ */
+int verify_simulator(int argc, char* argv[]) {
+	struct verify_spec spec = { 0, 1, 0, "golden" };
+	int seed = 1;
+	long min_rate = DEFAULT_MIN_RATE;
+	int valid_arguments = argc >= 3 && parse_int_argument(argv[2], &spec.num_traces);
+	for (int i = 3; valid_arguments && i < argc; i++) {
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			valid_arguments = parse_int_argument(argv[++i], &seed);
+		} else if (strcmp(argv[i], "--min-rate") == 0 && i + 1 < argc) {
+			valid_arguments = parse_long_argument(argv[++i], &min_rate);
+		} else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+			spec.golden_dir = argv[++i];
+		} else {
+			valid_arguments = 0;
+		}
+	}
+	if (!valid_arguments) {
+		print_error_and_instructions();
+		return 1;
+	}
+
+	spec.seed = seed;
+	spec.min_rate = min_rate;
+	return run_verification(&spec);
+}
+
+/*
+ * Check the optional arguments of a batch of traces, which simulates one policy over every trace and writes
+ * the output and the averages of each of them.
+ *
+ * options:			a pointer to the optional arguments
+ * num_policies:	the number of policies given
+ *
+ * Returns: 1 if they are valid, 0 otherwise
+ */
+static int valid_batch_options(const struct run_options* options, int num_policies) {
+	return num_policies == 1 && !options->print_parse_stats && !options->streaming && !options->writer_thread && !options->bench && options->metrics_format == -1
+		&& options->percentiles == -1 && options->num_sweep_grids == 0 && options->trace_path == NULL && options->checkpoint_path == NULL && options->resume_path == NULL
+		&& options->what_if_path == NULL;
+}
+
+/*
+ * Check the optional arguments of a parameter sweep, which simulates every grid point on one CPU and writes
+ * the averages only, so no option of the output file applies to it.
+ *
+ * options:	a pointer to the optional arguments
+ *
+ * Returns: 1 if they are valid, 0 otherwise
+ */
+static int valid_sweep_options(const struct run_options* options) {
+	return options->output_dir == NULL && !options->streaming && !options->bench && options->num_cpus == 1 && options->metrics_format == -1 && options->percentiles == -1
+		&& options->output_format == OUTPUT_TEXT && !options->writer_thread && options->trace_path == NULL && options->checkpoint_path == NULL && options->resume_path == NULL && options->what_if_path == NULL;
+}
+
+/*
+ * Check the optional arguments of a simulation of one or more policies over one input. Streaming, the
+ * benchmark, several CPUs, the metrics report and the timeline only work with one policy.
+ *
+ * options:			a pointer to the optional arguments
+ * num_policies:	the number of policies given
+ *
+ * Returns: 1 if they are valid, 0 otherwise
+ */
+static int valid_simulation_options(const struct run_options* options, int num_policies) {
+	return options->num_sweep_grids == 0 && options->output_dir == NULL && !(options->print_parse_stats && options->streaming)
+		&& (num_policies == 1 || (!options->streaming && !options->bench && options->num_cpus == 1 && options->metrics_format == -1 && options->trace_path == NULL))
+		&& !(options->bench && options->streaming);
+}
+
+/*
+ * Check the optional arguments of a simulation that writes checkpoints or resumes from one, which needs the
+ * whole input in memory, one policy and one CPU.
+ *
+ * options:			a pointer to the optional arguments
+ * num_policies:	the number of policies given
+ *
+ * Returns: 1 if they are valid (or there is no checkpoint), 0 otherwise
+ */
+static int valid_checkpoint_options(const struct run_options* options, int num_policies) {
+	return (options->checkpoint_path == NULL && options->resume_path == NULL)
+		|| (num_policies == 1 && !options->streaming && options->num_cpus == 1 && !options->bench && options->trace_path == NULL && options->percentiles == -1);
+}
+
+/*
+ * Check the optional arguments of a what-if analysis, which takes no other option but the parameters of its
+ * one policy.
+ *
+ * options:			a pointer to the optional arguments
+ * num_policies:	the number of policies given
+ *
+ * Returns: 1 if they are valid (or there are no what-if queries), 0 otherwise
+ */
+static int valid_what_if_options(const struct run_options* options, int num_policies) {
+	return options->what_if_path == NULL
+		|| (num_policies == 1 && !options->print_parse_stats && !options->streaming && options->output_format == OUTPUT_TEXT && !options->writer_thread && !options->bench
+			&& options->num_cpus == 1 && options->metrics_format == -1 && options->percentiles == -1 && options->trace_path == NULL && options->checkpoint_path == NULL
+			&& options->resume_path == NULL);
 }
 
 /*
  * The main function for the program.
  */
 int main(int argc, char* argv[]) {
-	if (argc != 3 || strcmp(argv[1], "input.dat") != 0 || (strcmp(argv[2], "SPN") != 0 && strcmp(argv[2], "SRT") != 0)) {
-		/* If the program is run with the wrong arguments, print out the instructions and exit. */
-		print_error_and_instructions();
+	if (argc == 4 && strcmp(argv[1], "--convert") == 0) {
+		/* Convert a binary event log to the text format and exit. */
+		exit(convert_event_log(argv[2], argv[3]) == 0 ? 0 : 1);
+	} else if (argc >= 2 && strcmp(argv[1], "--generate") == 0) {
+		/* Write a synthetic input file and exit. */
+		exit(generate_input(argc, argv));
+	} else if (argc >= 2 && strcmp(argv[1], "--verify") == 0) {
+		/* Check the simulator and exit. */
+		exit(verify_simulator(argc, argv));
+	}
+
+	/* Check the optional arguments after the 2 required ones. In a parameter sweep, the policy is replaced by
+	 * the parameter grids, which are optional arguments themselves. */
+	const char* const queue_names[] = { "global", "balanced", "stealing" };
+	const char* const metrics_names[] = { "json", "csv" };
+	const char* const percentiles_names[] = { "hdr", "exact" };
+	struct run_options options = { 0, 0, OUTPUT_TEXT, 0, 0, 1, QUEUE_GLOBAL, -1, -1 };
+	default_policy_params(&options.params);
+	options.num_sweep_grids = 0;
+	options.num_threads = 0;
+	options.csv_path = NULL;
+	options.output_dir = NULL;
+	options.trace_path = NULL;
+	options.checkpoint_path = NULL;
+	options.checkpoint_interval = 5;
+	options.resume_path = NULL;
+	options.what_if_path = NULL;
+	int batching = argc >= 2 && strcmp(argv[1], "--batch") == 0;
+	int sweeping = !batching && argc >= 3 && strcmp(argv[2], "--sweep") == 0;
+	int valid_options = 1;
+	for (int i = batching ? 4 : sweeping ? 2 : 3; i < argc; i++) {
+		if (strcmp(argv[i], "--parse-stats") == 0) {
+			options.print_parse_stats = 1;
+		} else if (strcmp(argv[i], "--stream") == 0) {
+			options.streaming = 1;
+		} else if (strcmp(argv[i], "--binary") == 0) {
+			options.output_format = OUTPUT_BINARY;
+		} else if (strcmp(argv[i], "--writer-thread") == 0) {
+			options.writer_thread = 1;
+		} else if (strcmp(argv[i], "--bench") == 0) {
+			options.bench = 1;
+		} else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+			valid_options &= parse_int_argument(argv[++i], &options.num_cpus) && options.num_cpus > 0;
+		} else if (strcmp(argv[i], "--queue") == 0 && i + 1 < argc) {
+			options.queue_mode = parse_name_argument(argv[++i], queue_names, 3);
+			valid_options &= options.queue_mode != -1;
+		} else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+			options.metrics_format = parse_name_argument(argv[++i], metrics_names, 2);
+			valid_options &= options.metrics_format != -1;
+		} else if (strcmp(argv[i], "--percentiles") == 0 && i + 1 < argc) {
+			options.percentiles = parse_name_argument(argv[++i], percentiles_names, 2);
+			valid_options &= options.percentiles != -1;
+		} else if (strcmp(argv[i], "--quantum") == 0 && i + 1 < argc) {
+			valid_options &= parse_long_argument(argv[++i], &options.params.quantum) && options.params.quantum > 0;
+		} else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) {
+			valid_options &= parse_int_argument(argv[++i], &options.params.num_levels) && options.params.num_levels >= 1 && options.params.num_levels <= 16;
+		} else if (strcmp(argv[i], "--boost") == 0 && i + 1 < argc) {
+			valid_options &= parse_long_argument(argv[++i], &options.params.boost_interval);
+		} else if (strcmp(argv[i], "--aging") == 0 && i + 1 < argc) {
+			valid_options &= parse_long_argument(argv[++i], &options.params.aging_interval);
+		} else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc && options.num_sweep_grids < MAX_SWEEP_GRIDS) {
+			options.sweep_grids[options.num_sweep_grids++] = argv[++i];
+		} else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			valid_options &= parse_int_argument(argv[++i], &options.num_threads) && options.num_threads > 0;
+		} else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+			options.csv_path = argv[++i];
+		} else if (strcmp(argv[i], "--output-dir") == 0 && i + 1 < argc) {
+			options.output_dir = argv[++i];
+		} else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+			options.trace_path = argv[++i];
+		} else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+			options.checkpoint_path = argv[++i];
+		} else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+			valid_options &= parse_int_argument(argv[++i], &options.checkpoint_interval) && options.checkpoint_interval > 0;
+		} else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+			options.resume_path = argv[++i];
+		} else if (strcmp(argv[i], "--what-if") == 0 && i + 1 < argc) {
+			options.what_if_path = argv[++i];
+		} else {
+			valid_options = 0;
+		}
+	}
+
+	if (options.metrics_format != -1 && !METRICS_ENABLED) {
+		printf("ERROR: This build has no metrics; rebuild it with \"make clean; make METRICS=1\"!\n");
 		exit(1);
-	} else {
-		FILE* input_file = fopen(argv[1], "r");			// open the file "input.dat" for reading
-		FILE* output_file = fopen("output.dat", "w");	// open/create the file "output.dat" for writing
-		if (input_file == NULL) {
-			/* If a problem occurs with opening "input.dat", print out an error statement and exit. */
-			printf("ERROR: Cannot open file \"%s\"!\n", argv[1]);
+	}
+
+	if (batching) {
+		const struct policy* policies[MAX_POLICIES];
+		int num_policies = argc >= 4 ? parse_policy_list(argv[3], policies) : 0;
+		if (!valid_options || !valid_batch_options(&options, num_policies)) {
+			print_error_and_instructions();
 			exit(1);
-		} else if (output_file == NULL) {
-			/* If a problem occurs with opening/creating "output.dat", print out an error statement and exit. */
-			printf("ERROR: Cannot open/create file \"output.dat\"\n");
+		}
+		exit(simulate_batch(argv[2], policies[0], &options));
+	}
+
+	if (sweeping) {
+		if (!valid_options || !valid_sweep_options(&options)) {
+			print_error_and_instructions();
 			exit(1);
-		} else {
-			/* Get a list of processes from the file "input.dat". */
-			struct queue* process_list = read_input(input_file);
-
-			/* Close the file "input.dat" after reading and deallocate unneeded memory. */
-			fclose(input_file);
-			free(input_file);
-
-			if (strcmp(argv[2], "SPN") == 0) {
-				/* The SPN scheduling policy */
-				spn(process_list, output_file);
-			} else if (strcmp(argv[2], "SRT") == 0) {
-				/* The SRT scheduling policy */
-				srt(process_list, output_file);
-			}
-
-			/* Close the file "output.dat" after writing and deallocate unneeded memory. */
-			free(process_list);
-			fclose(output_file);
-			free(output_file);
 		}
+		exit(sweep_parameters(argv[1], &options));
+	}
+
+	const struct policy* policies[MAX_POLICIES];
+	int num_policies = argc >= 3 ? parse_policy_list(argv[2], policies) : 0;
+	if (num_policies == 0 || !valid_options || !valid_simulation_options(&options, num_policies) || !valid_checkpoint_options(&options, num_policies)
+			|| !valid_what_if_options(&options, num_policies)) {
+		/* If the program is run with the wrong arguments, print out the instructions and exit. */
+		print_error_and_instructions();
+		exit(1);
+	} else if (options.what_if_path != NULL) {
+		exit(answer_queries(argv[1], policies[0], &options));
+	} else if (num_policies == 1) {
+		exit(run_policy(argv[1], policies[0], &options));
+	} else {
+		exit(compare_policies(argv[1], policies, num_policies, &options));
 	}
 }
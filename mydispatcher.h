@@ -6,26 +6,156 @@
  * - Course: COMP 354: Operating Systems
  * - Instructor: Shikha Mittal
  * - Date created: 05/15/2020
- * - Last updated: 05/28/2020
+ * - Last updated: 10/17/2026
  */
 
+#include <limits.h>
+#include <math.h>
+#include <setjmp.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <pthread.h>
 
-/* Representation of a process. */
-struct process {
-	int id;						// the ID of the process
-	int arrival_time;			// the arrival time of the process
-	int service_time;			// the service time of the process
-	int remaining_time;			// the amount of time the process still has to run
+/* Representation of a memory pool that owns all processes and queue nodes created during a run. */
+struct arena {
+	struct arena_block* blocks;	// the blocks of memory in use, the most recent one first
+	struct arena_block* spare_blocks;	// the blocks kept for reuse by reset_arena()
+	char* next_free;			// the next unused byte in the most recent block
+	size_t remaining_bytes;		// the number of unused bytes left in the most recent block
+	struct node* free_nodes;	// the queue nodes that have been released and can be reused
+	long num_allocations;		// the number of calls to malloc() made by the pool
+	size_t allocated_bytes;		// the number of bytes requested from malloc() by the pool
+	jmp_buf* out_of_memory;		// where to jump to if malloc() fails, or NULL to exit the program
+};
+
+/* Create a new memory pool. */
+struct arena* create_arena();
+
+/* Hand out a piece of memory from a memory pool. */
+void* arena_alloc(struct arena* current_arena, size_t size);
+
+/* Grow a piece of memory handed out by a memory pool. */
+void* arena_grow(struct arena* current_arena, void* old_piece, size_t old_size, size_t new_size);
+
+/* Get a queue node from a memory pool. */
+struct node* arena_alloc_node(struct arena* current_arena);
+
+/* Give a queue node back to a memory pool for reuse. */
+void arena_release_node(struct arena* current_arena, struct node* node_to_release);
+
+/* Take back everything a memory pool has handed out, keeping its blocks for reuse. */
+void reset_arena(struct arena* current_arena);
+
+/* Deallocate a memory pool together with everything it has handed out. */
+void destroy_arena(struct arena* current_arena);
+
+/* Representation of a table of processes, stored column by column so that the scheduling loops walk
+ * contiguous arrays. A process is referred to by its index (row) in the table. */
+struct process_table {
+	int* id;					// the IDs of the processes
+	long* arrival_time;			// the arrival times of the processes
+	long* service_time;			// the service times of the processes
+	long* remaining_time;		// the amount of time each process still has to run
+	int* free_slots;			// the indices of rows released for reuse (only used when streaming)
+	int num_free;				// the number of rows released for reuse
+	int size;					// the current number of rows in the table
+	int capacity;				// the number of rows the columns can hold before they have to grow
+	struct arena* pool;			// the memory pool the columns are taken from
+};
+
+/* Create a new process table. */
+struct process_table* create_process_table(struct arena* pool);
+
+/* Add a process to the end of a process table. */
+int process_table_add(struct process_table* table, long process_arrival, long process_service);
+
+/* Put a process into a released row of a process table, or at the end if there is none. */
+int process_table_acquire(struct process_table* table, int process_id, long process_arrival, long process_service);
+
+/* Release a row of a process table for reuse. */
+void process_table_release(struct process_table* table, int index);
+
+/* Representation of a reader that parses processes from an input file (or a pipe) in chunks, so that the
+ * whole file never has to be in memory. */
+struct input_reader {
+	int fd;						// the file descriptor being read from
+	const char* path;			// the path of the input, used in error statements
+	char* buffer;				// the chunk of input being parsed
+	size_t capacity;			// the size of the buffer
+	size_t start;				// the position of the first unparsed byte in the buffer
+	size_t end;					// the position after the last byte read into the buffer
+	int end_of_input;			// whether everything has been read from the file descriptor
+	int line_number;			// the number of the last line parsed
+	int blank_line;				// the number of the first blank line, if any
+	int num_processes;			// the number of processes read so far
+	long last_arrival;			// the arrival time of the last process read
+	long finish_bound;			// the time all processes read so far finish by, at the latest
+	int error;					// whether the input has turned out to be unreadable or malformed
+	long num_bytes;				// the number of bytes read so far
+};
+
+/* Open a reader on an input file, or on stdin if the path is "-". */
+struct input_reader* open_input_reader(const char* input_path, struct arena* pool);
+
+/* Read the next process from a reader. */
+int reader_next_process(struct input_reader* reader, long* read_arrival, long* read_service);
+
+/* Close a reader. */
+void close_input_reader(struct input_reader* reader);
+
+/* Representation of a stream of arriving processes in order of arrival time. The stream is either a
+ * cursor into a process table that holds the whole input, or a reader that adds each process to the table
+ * only when it is about to arrive (streaming mode). */
+struct arrival_stream {
+	struct process_table* table;	// the table the processes arrive from
+	int next;						// the index of the next process to arrive (-1 at the end when streaming)
+	struct input_reader* reader;	// the reader processes are taken from when streaming, or NULL
 };
 
-/* Create a new process. */
-struct process* create_process(int process_id, int process_arrival, int process_service);
+/* Start a stream over a process table that holds the whole input. */
+void init_table_stream(struct arrival_stream* stream, struct process_table* table);
+
+/* Start a stream that reads processes lazily from a reader into a process table. */
+void init_reader_stream(struct arrival_stream* stream, struct process_table* table, struct input_reader* reader);
+
+/* Read the next process into the table of a streaming arrival stream. */
+void advance_reader_stream(struct arrival_stream* stream);
+
+/* Check whether some process has not yet arrived. */
+static inline int has_arrival(const struct arrival_stream* stream) {
+	if (stream->reader == NULL) {
+		return stream->next < stream->table->size;
+	}
+	return stream->next >= 0;
+}
+
+/* Get the arrival time of the next process to arrive. Only valid if has_arrival() holds. */
+static inline long next_arrival_time(const struct arrival_stream* stream) {
+	return stream->table->arrival_time[stream->next];
+}
+
+/* Retrieve the index of the next process to arrive and move past it. */
+static inline int take_arrival(struct arrival_stream* stream) {
+	int taken = stream->next;
+	if (stream->reader == NULL) {
+		stream->next++;
+	} else {
+		advance_reader_stream(stream);
+	}
+	return taken;
+}
+
+/* Tell a stream that a process has completed, so that its row can be reused when streaming. */
+static inline void finish_arrival(struct arrival_stream* stream, int index) {
+	if (stream->reader != NULL) {
+		process_table_release(stream->table, index);
+	}
+}
 
 /* Representation of a node used for a queue of processes (implemented with a doubly linked list). */
 struct node {
-	struct process* data;		// the process refered to by this node
+	int data;					// the index of the process refered to by this node
 	struct node* prev;			// the previous node in the queue
 	struct node* next;			// the next node in the queue
 };
@@ -35,28 +165,756 @@ struct queue {
 	struct node* head;			// the head (first node) of the queue
 	struct node* rear;			// the rear (last node) of the queue
 	int size;					// the current size (number of nodes) of the queue
+	struct arena* pool;			// the memory pool the nodes of the queue are taken from
 };
 
 /* Create a new queue. */
-struct queue* create_queue();
+struct queue* create_queue(struct arena* pool);
 
 /* Add a process to the end of a queue. */
-void enqueue(struct queue* current_queue, struct process* process_to_add);
+void enqueue(struct queue* current_queue, int process_to_add);
 
-/* Re-sort a queue by the remaining time of processes. */
-void resort_after_adding(struct queue* current_queue);
+/* Retrive and remove the first (frontmost) process of a queue. */
+int dequeue(struct queue* current_queue);
 
-/* Add a process to the end of a queue and then re-sort the queue. */
-void enqueue_with_sorting(struct queue* current_queue, struct process* process_to_add);
+/* Representation of an entry in a priority queue of processes. */
+struct heap_entry {
+	int data;					// the index of the process refered to by this entry
+	long key;					// the remaining time of the process when it was added
+	long order;					// the order in which the process was added, used to break ties
+};
 
-/* Retrive and remove the first (frontmost) process of a queue. */
-struct process* dequeue(struct queue* current_queue);
+/* Representation of a priority queue of processes (implemented with an array-backed binary min-heap). */
+struct heap {
+	struct heap_entry* entries;	// the entries of the heap, stored contiguously in level order
+	int size;					// the current size (number of entries) of the heap
+	int num_unsorted;			// the number of entries at the end added by heap_append() and not yet in place
+	int capacity;				// the number of entries the array can hold before it has to grow
+	long next_order;			// the order to be given to the next added process
+	struct arena* pool;			// the memory pool the array is taken from
+};
+
+/* Create a new priority queue. */
+struct heap* create_heap(struct arena* pool);
+
+/* Add a process to a priority queue with a specified key. */
+void heap_insert(struct heap* current_heap, int process_to_add, long key);
+
+/* Add a process to a priority queue with a specified key, moving it into place only when the queue is next
+ * looked at. */
+void heap_append(struct heap* current_heap, int process_to_add, long key);
+
+/* Move the processes added with heap_append() into place. */
+void heap_fix(struct heap* current_heap);
+
+/* Retrieve (without removing) the process with the smallest key in a priority queue. */
+int heap_peek(struct heap* current_heap);
+
+/* Retrieve (without removing) the smallest key in a priority queue. */
+long heap_peek_key(struct heap* current_heap);
+
+/* Retrieve and remove the process with the smallest key in a priority queue. */
+int heap_extract_min(struct heap* current_heap);
+
+/* Work out the key of a process in the priority queue of SPN or SRT. With aging, a process counts as one time unit
+ * shorter for every aging_interval time units it has waited since it arrived, so its priority at time t is
+ * aging_interval * remaining - (t - ready_since), where ready_since is the time it would have been ready since had
+ * it never waited (its arrival time plus the time it has run), which keeps changing. The term -t is the same for
+ * every process, though, so leaving it out keeps their order: the key aging_interval * remaining + ready_since never
+ * changes while the process waits, and aging costs no updates of the queue at all. Keys that do not fit in a long
+ * are clamped. */
+static inline long aged_key(long remaining, long ready_since, long aging_interval) {
+	if (aging_interval == 0) {
+		return remaining;
+	} else if (remaining > (LONG_MAX - ready_since) / aging_interval) {
+		return LONG_MAX;
+	}
+	return aging_interval * remaining + ready_since;
+}
+
+/* Results of reading one line of input. */
+#define SCAN_PROCESS 1				// a process was read
+#define SCAN_BLANK 0				// the line only contains whitespace
+#define SCAN_MALFORMED -1			// the line does not have the correct format
+
+/* Read one line of input from a buffer. */
+int scan_input_line(const char** cursor, const char* end, long* read_arrival, long* read_service);
+
+/* Representation of measurements taken while reading an input file. */
+struct input_stats {
+	long bytes;					// the size of the input file in bytes
+	double seconds;				// the time spent reading and parsing the input file
+};
+
+/* Get the current time of a monotonic clock in seconds. */
+double current_seconds();
+
+/* The largest length of an error message about a malformed input, including its terminating null character. */
+#define INPUT_ERROR_MAX 512
+
+/* Create a table of processes from input held in memory. */
+struct process_table* parse_input(const char* input, size_t input_size, const char* input_path, struct arena* pool, char* error);
+
+/* Create a table of processes from the data in an input file. */
+struct process_table* read_input(const char* input_path, struct arena* pool, struct input_stats* stats);
+
+/* Formats an output writer can write results in. */
+#define OUTPUT_TEXT 0				// the text format of "output.dat"
+#define OUTPUT_BINARY 1				// a compact binary event log
+#define OUTPUT_NONE 2				// nothing is written (only the averages are needed)
+#define OUTPUT_TRACE 3				// a timeline in the Chrome trace-event JSON format
+#define OUTPUT_RECORDS 4			// the result of every completed process is kept in memory
+
+/* Representation of the result of a process that completed, as kept in memory by an output writer. The
+ * waiting time and turnaround time follow from the other fields. */
+struct process_result {
+	int id;						// the ID of the process
+	int cpu;					// the CPU the process completed on, or -1 for a single-CPU simulation
+	long arrival_time;			// the arrival time of the process
+	long service_time;			// the service time of the process
+	long start_time;			// the time the process was last dispatched
+	long finish_time;			// the time the process completed
+};
+
+/* Representation of the output stage, which formats results into a large buffer and writes it out in big
+ * chunks, optionally from a separate writer thread. */
+struct output_writer {
+	int fd;						// the file descriptor of the output file
+	int format;					// the format results are written in
+	char* buffer;				// the buffer results are formatted into
+	size_t used;				// the number of bytes in the buffer
+	int error;					// whether some part of the output could not be written
+	int threaded;				// whether the buffers are written by a writer thread
+	char* pending;				// the buffer handed over to the writer thread
+	size_t pending_size;		// the number of bytes in the handed-over buffer (0 once written)
+	int stopping;				// whether the writer thread should stop once everything is written
+	pthread_t thread;			// the writer thread
+	pthread_mutex_t lock;		// protects the fields shared with the writer thread
+	pthread_cond_t changed;		// signalled whenever a buffer is handed over or written
+	long size;					// the number of bytes handed over for writing so far
+	struct output_writer* trace;	// a timeline writer every event is also written to, or NULL
+	int num_tracks;				// the number of CPU tracks of a timeline named so far
+	struct process_result* records;	// the results kept so far (OUTPUT_RECORDS only)
+	long num_records;			// the number of results kept
+	long records_capacity;		// the number of results the array can hold before it has to grow
+	struct arena* pool;			// the memory pool the array of results is taken from
+};
+
+/* Open an output writer on a file. */
+struct output_writer* open_output_writer(const char* output_path, int format, int threaded, struct arena* pool);
+
+/* Open an output writer that carries on writing a file from a specified size. */
+struct output_writer* reopen_output_writer(const char* output_path, int format, int threaded, long size, struct arena* pool);
+
+/* Write the result of a process that ran until it completed. */
+void write_completion(struct output_writer* writer, int id, long start, long finish, long arrival, long service, int cpu);
+
+/* Write the result of a process that ran until it was preempted. */
+void write_preemption(struct output_writer* writer, int id, long start, long end, int cpu);
+
+/* Write that a process arrived (only timelines record it). */
+void write_arrival(struct output_writer* writer, int id, long time);
+
+/* Write that a CPU was idle for some time (only timelines record it). */
+void write_idle(struct output_writer* writer, long start, long end, int cpu);
+
+/* Make sure everything written to an output writer so far is in its file. */
+int sync_output_writer(struct output_writer* writer);
+
+/* Write out everything left in an output writer and close its file. */
+int close_output_writer(struct output_writer* writer);
+
+/* Convert a binary event log to the text format. */
+int convert_event_log(const char* log_path, const char* output_path);
+
+/* Representation of the tunable parameters of the scheduling policies. */
+struct policy_params {
+	long quantum;				// the time quantum of RR, and of the top level of MLFQ
+	int num_levels;				// the number of priority levels of MLFQ
+	long boost_interval;		// how often MLFQ moves every process back to the top level (0 for never)
+	long aging_interval;		// how long a process waits in SPN and SRT to count as one unit shorter (0 for never)
+};
+
+/* Set the parameters of the scheduling policies to their default values. */
+void default_policy_params(struct policy_params* params);
+
+/* Representation of a scheduling policy, which is plugged into the shared simulation loop. Each policy keeps
+ * the processes in the Ready state in whatever structure suits it, and the loop calls the functions below
+ * whenever it needs a decision. All of them receive the current time. */
+struct policy {
+	const char* name;			// the name of the policy used on the command line
+	int preempt_on_arrival;		// whether an arrival may preempt the running process
+	void* (*create)(const struct policy_params* params, struct arena* pool);	// create the Ready state
+	void (*add_ready)(void* ready, const struct process_table* table, int process, long now);	// add a process
+	int (*num_ready)(void* ready);	// get the number of processes in the Ready state
+	int (*select_next)(void* ready, const struct process_table* table, long now);	// remove the next process
+	long (*time_slice)(void* ready, const struct process_table* table, int process);	// 0 for unlimited
+	int (*should_preempt)(void* ready, const struct process_table* table, int running, int slice_expired, long now);
+	void (*preempt)(void* ready, const struct process_table* table, int process, int slice_expired, long now);
+	void (*save)(void* ready, int running, FILE* checkpoint_file);	// write the Ready state to a checkpoint
+	int (*load)(void* ready, const struct process_table* table, int running, FILE* checkpoint_file);	// read it back
+	long (*running_key)(void* ready, const struct process_table* table, int running, long now);	// see below
+};
+
+/* The running_key function of a policy that arrivals can preempt gives a key of a running process that does not
+ * change while it runs, such that of several running processes, the one with the largest key is the first the
+ * policy would preempt. It lets several CPUs sharing a Ready state find the process to preempt without looking at
+ * every CPU. Policies that arrivals cannot preempt leave it NULL. */
+
+/* Work out the time a time slice given at a specified time ends, or -1 if it is unlimited. A time slice that would
+ * end after the largest time a long holds never ends either, since the input is checked so that every process
+ * finishes by then. */
+static inline long slice_end_time(long now, long slice) {
+	return slice > 0 && slice <= LONG_MAX - now ? now + slice : -1;
+}
+
+/* The available scheduling policies. */
+extern const struct policy fcfs_policy;
+extern const struct policy rr_policy;
+extern const struct policy spn_policy;
+extern const struct policy srt_policy;
+extern const struct policy hrrn_policy;
+extern const struct policy mlfq_policy;
+
+/* Find a scheduling policy by name. */
+const struct policy* find_policy(const char* name);
+
+/* Representation of a sum of many values that also keeps the rounding error of every addition (compensated,
+ * or Kahan-Babuska, summation), so that it stays accurate to the last bit of a double over any number of
+ * values, however large. */
+struct compensated_sum {
+	double sum;					// the sum as rounded
+	double compensation;		// the total of the rounding errors of the additions
+};
+
+/* Add a value to a compensated sum. */
+static inline void add_to_sum(struct compensated_sum* total, double value) {
+	double rounded = total->sum + value;
+	if (fabs(total->sum) >= fabs(value)) {
+		total->compensation += (total->sum - rounded) + value;
+	} else {
+		total->compensation += (value - rounded) + total->sum;
+	}
+	total->sum = rounded;
+}
+
+/* Get the value of a compensated sum. Once the sum is infinite (a normalized turnaround time of a process with
+ * a service time of 0), the compensation means nothing and is left out. */
+static inline double sum_value(const struct compensated_sum* total) {
+	return isfinite(total->sum) ? total->sum + total->compensation : total->sum;
+}
+
+/* Representation of the results of a simulation. */
+struct sim_results {
+	int num_processes;					// the number of processes that completed
+	struct compensated_sum sum_turnaround;	// the total turnaround time of all processes
+	struct compensated_sum sum_normalized_turnaround;	// the total normalized turnaround time of all processes
+	struct compensated_sum sum_waiting;	// the total waiting time of all processes
+	long num_events;					// the number of completions and preemptions written to the output
+	struct latency_stats* latency;		// where the distributions of waiting and turnaround times are kept, or
+										// NULL if they are not needed (set before the simulation)
+	struct checkpointer* checkpoint;	// where checkpoints are written and resumed from, or NULL for none
+										// (set before the simulation)
+	struct what_if* what_if;			// where a what-if analysis keeps its snapshots, or NULL for none (set
+										// before the simulation)
+};
+
+/* How many steps of a simulation pass between looks at the clock to see whether a checkpoint is due. */
+#define CHECKPOINT_CHECK_STEPS 4096
+
+/* Representation of the checkpoints of a simulation: where and how often they are written, and the
+ * checkpoint the simulation resumes from. */
+struct checkpointer {
+	const char* path;				// the path of the checkpoint file to write, or NULL to write none
+	double interval;				// the number of seconds between checkpoints
+	double next_seconds;			// the time (as given by current_seconds()) the next checkpoint is due
+	int steps;						// the number of steps since the clock was last looked at
+	unsigned long input_hash;		// a hash of the input, worked out before the first checkpoint
+	int input_hashed;				// whether the hash of the input has been worked out
+	FILE* resume_file;				// the checkpoint being resumed from, read up to its state, or NULL
+	int resume_processes;			// the number of processes of the input of that checkpoint
+	unsigned long resume_hash;		// the hash of the input of that checkpoint
+	long output_size;				// the size of the output file when that checkpoint was taken
+	int first_row;					// the first row whose process may not have completed, which the next
+									// checkpoint starts looking at
+	int num_written;				// the number of checkpoints written
+	int error;						// whether a checkpoint could not be written or read
+};
+
+/* The state of the simulation loop kept in a checkpoint, apart from the Ready state of the policy. */
+struct sim_snapshot {
+	long current_time;				// the current time
+	int running_process;			// the index of the running process, or -1 if there is none
+	long start_time;				// the time the running process was dispatched
+	long slice_end;					// the time the time slice of the running process ends, or -1 if unlimited
+};
+
+/* Create the state for writing checkpoints of a simulation and resuming it. */
+struct checkpointer* create_checkpointer(const char* path, double interval, struct arena* pool);
+
+/* Open a checkpoint to resume from, checking that it was taken with the same policy and parameters. */
+int open_checkpoint(struct checkpointer* checkpoint, const char* resume_path, const struct policy* policy, const struct policy_params* params, int output_format);
+
+/* Check whether a checkpoint is due, looking at the clock only once every CHECKPOINT_CHECK_STEPS steps. */
+static inline int checkpoint_due(struct checkpointer* checkpoint) {
+	if (++checkpoint->steps < CHECKPOINT_CHECK_STEPS) {
+		return 0;
+	}
+	checkpoint->steps = 0;
+	if (checkpoint->path == NULL || current_seconds() < checkpoint->next_seconds) {
+		return 0;
+	}
+	checkpoint->next_seconds = current_seconds() + checkpoint->interval;
+	return 1;
+}
+
+/* Write a checkpoint of a simulation. */
+void save_checkpoint(struct checkpointer* checkpoint, const struct policy* policy, const struct policy_params* params, void* ready, const struct arrival_stream* arrivals, struct output_writer* output, const struct sim_snapshot* snapshot, const struct sim_results* results);
+
+/* Resume a simulation from the checkpoint opened by open_checkpoint(). */
+int load_checkpoint(struct checkpointer* checkpoint, const struct policy* policy, void* ready, struct arrival_stream* arrivals, struct sim_snapshot* snapshot, struct sim_results* results);
+
+/* Write the state of a simulation loop to a stream, and read it back. */
+void write_sim_state(FILE* state_file, const struct policy* policy, void* ready, const struct arrival_stream* arrivals, const struct sim_snapshot* snapshot, const struct sim_results* results, int first_row);
+int read_sim_state(FILE* state_file, const struct policy* policy, void* ready, struct arrival_stream* arrivals, struct sim_snapshot* snapshot, struct sim_results* results);
+
+/* Release the checkpoint a simulation was to resume from, if it was never read. */
+void close_checkpointer(struct checkpointer* checkpoint);
+
+/* Read a process index from a checkpoint. */
+int read_checkpoint_process(FILE* checkpoint_file, const struct process_table* table, int* process);
+
+/* Write a queue to a checkpoint, and read it back. */
+void save_queue(const struct queue* current_queue, FILE* checkpoint_file);
+int load_queue(struct queue* current_queue, const struct process_table* table, FILE* checkpoint_file);
+
+/* Write a priority queue to a checkpoint, and read it back. */
+void save_heap(struct heap* current_heap, FILE* checkpoint_file);
+int load_heap(struct heap* current_heap, const struct process_table* table, FILE* checkpoint_file);
+
+/* Simulate a scheduling policy on a stream of arriving processes. */
+void simulate(const struct policy* policy, const struct policy_params* params, struct arrival_stream* arrivals, struct output_writer* output, struct arena* pool, struct sim_results* results);
+
+/* Print out the averages of the results of a simulation. */
+void print_averages(const struct sim_results* results);
+
+/* Write the averages of the results of a simulation to a stream. */
+void write_averages(FILE* stream, const struct sim_results* results);
+
+/* The ways the percentiles of waiting and turnaround times can be worked out. */
+#define PERCENTILES_HISTOGRAM 0		// from a histogram of constant size, within 1% of the exact value
+#define PERCENTILES_EXACT 1			// from every value, which takes memory for every process
+
+/* The number of bits of a value kept by a histogram bucket, so that buckets are at most 1/128 of their values
+ * wide; smaller values get a bucket each. */
+#define HISTOGRAM_SUB_BITS 7
+
+/* The number of buckets of a histogram, enough for any non-negative long. */
+#define HISTOGRAM_NUM_BUCKETS ((64 - HISTOGRAM_SUB_BITS) << HISTOGRAM_SUB_BITS)
+
+/* The number of percentiles reported, which are p50, p95, p99 and p99.9. */
+#define NUM_PERCENTILES 4
+
+/* Representation of a log-linear (HDR-style) histogram of non-negative long values. */
+struct histogram {
+	long counts[HISTOGRAM_NUM_BUCKETS];	// the number of values in every bucket
+	long total;							// the number of values
+	long max;							// the largest value
+};
+
+/* Representation of the state kept while collecting the distributions of waiting and turnaround times. */
+struct latency_stats {
+	int mode;						// PERCENTILES_HISTOGRAM or PERCENTILES_EXACT
+	struct histogram waiting;		// the histogram of waiting times
+	struct histogram turnaround;	// the histogram of turnaround times
+	long* exact_waiting;			// every waiting time (PERCENTILES_EXACT only)
+	long* exact_turnaround;			// every turnaround time (PERCENTILES_EXACT only)
+	long num_exact;					// the number of values in both arrays
+	long exact_capacity;			// the number of values both arrays can hold before they have to grow
+	long* ready_since;				// the time each row of the table last became ready
+	int ready_since_capacity;		// the number of rows ready_since can hold
+	long max_starvation;				// the longest time any process waited in the Ready state in one stretch
+	int starved_id;					// the ID of that process
+	struct arena* pool;				// the memory pool everything above is taken from
+};
+
+/* Representation of the percentiles and maxima of the waiting and turnaround times of a simulation. */
+struct latency_summary {
+	long count;								// the number of processes
+	long waiting[NUM_PERCENTILES];			// the percentiles of the waiting times
+	long max_waiting;						// the longest waiting time
+	long turnaround[NUM_PERCENTILES];		// the percentiles of the turnaround times
+	long max_turnaround;					// the longest turnaround time
+	long max_starvation;						// the longest time a process waited in the Ready state in one stretch
+	int starved_id;							// the ID of that process
+};
+
+/* Create the state for collecting the distributions of waiting and turnaround times. */
+struct latency_stats* create_latency_stats(int mode, struct arena* pool);
+
+/* Record that a process became ready at a specified time. */
+void latency_ready(struct latency_stats* stats, const struct process_table* table, int process, long time);
+
+/* Record that a process was dispatched at a specified time. */
+void latency_dispatch(struct latency_stats* stats, const struct process_table* table, int process, long now);
+
+/* Record the waiting and turnaround times of a completed process. */
+void latency_complete(struct latency_stats* stats, long waiting, long turnaround);
+
+/* Work out the percentiles and maxima of the collected distributions. */
+void summarize_latency(struct latency_stats* stats, struct latency_summary* summary);
+
+/* Print out the percentiles and maxima of the waiting and turnaround times. */
+void print_latency_summary(const struct latency_summary* summary);
+
+/* The ways the CPUs of a multi-CPU simulation share the processes. */
+#define QUEUE_GLOBAL 0				// one Ready state shared by all CPUs
+#define QUEUE_BALANCED 1			// a Ready state per CPU; each arrival joins the less loaded of two CPUs
+#define QUEUE_STEALING 2			// a Ready state per CPU; an idle CPU steals from the others
+
+/* Representation of the statistics of one CPU of a multi-CPU simulation. */
+struct cpu_stats {
+	long busy_time;					// the total time the CPU ran some process
+	long migrations;				// the number of processes dispatched here after last running elsewhere
+};
+
+/* Representation of the results of a multi-CPU simulation, on top of those in sim_results. */
+struct smp_results {
+	int num_cpus;					// the number of CPUs
+	struct cpu_stats* cpus;			// an array of the statistics of every CPU
+	long start_time;				// the arrival time of the first process
+	long end_time;					// the time the last process completed
+};
+
+/* Simulate a scheduling policy on several CPUs. */
+void simulate_smp(const struct policy* policy, const struct policy_params* params, int num_cpus, int queue_mode, struct arrival_stream* arrivals, struct output_writer* output, struct arena* pool, struct sim_results* results, struct smp_results* smp_results);
+
+/* Print out the utilization and migrations of every CPU of a multi-CPU simulation. */
+void print_cpu_stats(const struct smp_results* smp_results);
+
+/* Representation of one of several simulations run in parallel over the same input. */
+struct policy_run {
+	const struct policy* policy;			// the scheduling policy
+	const struct policy_params* params;		// the parameters of the policy
+	const struct process_table* table;		// the table of processes, shared by all simulations
+	int output_format;						// the format of the output file
+	int writer_thread;						// whether the output file is written by a writer thread
+	char output_path[64];					// the path of the output file
+	struct sim_results results;				// the results of the simulation
+	int percentiles;						// how percentiles are worked out, or -1 if they are not needed
+	struct latency_summary latency;			// the percentiles of the simulation, if needed
+	int error;								// whether the output file could not be written
+	int started;							// whether the simulation runs on a thread of its own
+	pthread_t thread;						// the thread of the simulation
+};
+
+/* Create a private copy of a process table, sharing everything but the remaining times. */
+struct process_table* copy_process_table(const struct process_table* shared_table, struct arena* pool);
+
+/* Simulate several scheduling policies over the same table of processes in parallel. */
+int run_policies_in_parallel(struct policy_run* runs, int num_runs);
+
+/* Print out a table comparing the averages of several simulations. */
+void print_comparison(const struct policy_run* runs, int num_runs);
+
+/* Representation of a thread pool whose worker threads steal tasks from each other. */
+struct thread_pool;
+
+/* Get the number of processors available. */
+int num_processors();
+
+/* Create a thread pool with a number of worker threads. */
+struct thread_pool* create_thread_pool(int num_workers);
+
+/* Submit a task to a thread pool. */
+void thread_pool_submit(struct thread_pool* pool, void (*run)(void* argument), void* argument);
+
+/* Wait until every task submitted to a thread pool has finished. */
+void thread_pool_wait(struct thread_pool* pool);
+
+/* Stop the worker threads of a thread pool and deallocate it. */
+void destroy_thread_pool(struct thread_pool* pool);
+
+/* Representation of one configuration of a parameter sweep. */
+struct sweep_point {
+	const struct policy* policy;			// the scheduling policy
+	struct policy_params params;			// the parameters of the policy
+	const struct process_table* table;		// the table of processes, shared by all configurations
+	struct sim_results results;				// the results of the simulation
+};
+
+/* Expand a parameter grid into the configurations of a parameter sweep. */
+int expand_sweep_grid(const char* grid, const struct policy_params* defaults, struct sweep_point** points, int num_points, int* capacity);
+
+/* Simulate every configuration of a parameter sweep on a thread pool and write the averages as CSV. */
+int run_sweep(struct sweep_point* points, int num_points, int num_threads, const char* csv_path);
+
+/* The settings shared by every trace of a batch. */
+struct batch_settings {
+	const struct policy* policy;			// the scheduling policy
+	const struct policy_params* params;		// the parameters of the policy
+	int num_cpus;							// the number of CPUs to simulate
+	int queue_mode;							// how the CPUs share the processes
+	int output_format;						// the format of the output files, OUTPUT_TEXT or OUTPUT_BINARY
+};
+
+/* Representation of one trace of a batch, which is read and simulated by a task of its own. */
+struct batch_trace {
+	const char* input_path;					// the path of the trace
+	const char* output_path;				// the path of the output file of the trace
+	long size;								// the size of the trace in bytes
+	const struct batch_settings* settings;	// the settings shared by every trace
+	int error;								// whether the trace could not be read or its output could not be written
+	struct sim_results results;				// the results of the simulation
+};
+
+/* Find the traces of a batch, which are the files in a directory or the files listed in a file. */
+int collect_batch_traces(const char* source, const char* output_dir, const struct batch_settings* settings, struct arena* pool, struct batch_trace** traces);
+
+/* Read and simulate every trace of a batch on a thread pool and write the averages of each as CSV. */
+int run_batch(struct batch_trace* traces, int num_traces, int num_threads, const char* csv_path);
+
+/* How many steps of the original simulation of a what-if analysis pass between snapshots, at the least. */
+#define WHAT_IF_SNAPSHOT_STEPS 4096
+
+/* The largest number of edits in one what-if query. */
+#define MAX_WHAT_IF_EDITS 64
+
+/* Representation of a snapshot of the original simulation of a what-if analysis, kept in memory. */
+struct what_if_snapshot {
+	long current_time;				// the time the snapshot was taken
+	int next_arrival;				// the index of the next process to arrive at that time
+	int first_row;					// the first row whose process had not completed at that time
+	char* state;					// the state of the simulation loop, as written by write_sim_state()
+	size_t state_size;				// the number of bytes of the state
+};
+
+/* Representation of a what-if analysis, which simulates a policy over a table of processes once, keeping
+ * snapshots of the simulation, and then answers queries about edits to the processes by simulating only from
+ * the last snapshot before the edits to where the schedule becomes the same as the original one again. */
+struct what_if {
+	const struct policy* policy;			// the scheduling policy
+	const struct policy_params* params;		// the parameters of the policy
+	const struct process_table* original;	// the table of processes as read from the input
+	struct process_table* table;			// a copy of the table that the edits of a query are made to, which
+											// is the same as the original between queries
+	struct arena* pool;						// the memory pool of the analysis
+	struct arena* run_pool;					// the memory pool of a single simulation, reset before each one
+	struct sim_results original_results;	// the results of the original simulation
+	struct what_if_snapshot* snapshots;		// the snapshots, in the order they were taken
+	int num_snapshots;						// the number of snapshots
+	int snapshot_capacity;					// the number of snapshots the array can hold before it has to grow
+	long steps_left;						// the number of steps until the next snapshot is due
+	int first_row;							// the first row whose process had not completed at the last snapshot
+	int recording;							// whether the original simulation is running
+	char* idle_before;						// whether the CPU is idle right before each row arrives in the
+											// original simulation
+	struct compensated_sum* suffix_turnaround;	// the total turnaround time of the processes from each row on
+	struct compensated_sum* suffix_normalized_turnaround;	// the total normalized turnaround time of those
+	struct compensated_sum* suffix_waiting;	// the total waiting time of those
+	const struct what_if_snapshot* resume;	// the snapshot a re-simulation resumes from, or NULL to start afresh
+	int last_edited_row;					// the last row of the table that differs from the original
+	int stop_early;							// whether a re-simulation may stop once the schedule is the same as
+											// the original one again
+	int stopped_row;						// the row whose arrival a re-simulation stopped before, or -1 if it
+											// ran to the end
+	long stopped_time;						// the time the re-simulation stopped
+	int num_resumed;						// the number of processes that had completed at the snapshot
+	int error;								// whether the snapshot could not be resumed from
+};
+
+/* Representation of the answer to a what-if query. */
+struct what_if_answer {
+	struct sim_results results;		// the results as if the whole edited table had been simulated
+	long resumed_time;				// the time the re-simulation resumed at, or -1 if it started afresh
+	long stopped_time;				// the time it stopped at, or -1 if it ran to the end
+	int num_simulated;				// the number of processes that completed in the re-simulation
+};
+
+/* Check whether a snapshot of the original simulation of a what-if analysis is due. */
+static inline int what_if_snapshot_due(struct what_if* what_if) {
+	return what_if->recording && --what_if->steps_left <= 0;
+}
+
+/* Simulate a policy over a table of processes, keeping snapshots for what-if queries. */
+struct what_if* create_what_if(const struct policy* policy, const struct policy_params* params, const struct process_table* table);
+
+/* Take a snapshot of the original simulation of a what-if analysis. */
+void take_what_if_snapshot(struct what_if* what_if, const struct policy* policy, void* ready, const struct arrival_stream* arrivals, const struct sim_snapshot* snapshot, const struct sim_results* results);
+
+/* Restore the snapshot a what-if re-simulation resumes from. */
+int resume_what_if(struct what_if* what_if, const struct policy* policy, void* ready, struct arrival_stream* arrivals, struct sim_snapshot* snapshot, struct sim_results* results);
+
+/* Check whether a what-if re-simulation that has gone idle can stop. */
+int what_if_converged(struct what_if* what_if, int next_row, long now);
+
+/* Answer a what-if query, which is a list of edits to processes. */
+int answer_what_if(struct what_if* what_if, const char* query, struct what_if_answer* answer, char* error);
+
+/* Deallocate a what-if analysis together with its snapshots. */
+void destroy_what_if(struct what_if* what_if);
+
+/* Get the next random 64-bit number of a generator (SplitMix64), which synthetic workloads and the random traces
+ * of the self-check are drawn from. The state can start at any value, such as a seed. */
+static inline uint64_t next_random(uint64_t* state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/* The arrival processes of a synthetic workload. */
+#define ARRIVALS_POISSON 0
+#define ARRIVALS_BURSTY 1
+
+/* The service time distributions of a synthetic workload. */
+#define SERVICE_EXPONENTIAL 0
+#define SERVICE_UNIFORM 1
+#define SERVICE_PARETO 2
+
+/* Representation of the description of a synthetic workload. */
+struct workload_spec {
+	long num_processes;				// the number of processes
+	unsigned long seed;				// the seed of the random number generator
+	int arrival_process;			// ARRIVALS_POISSON or ARRIVALS_BURSTY
+	int service_distribution;		// SERVICE_EXPONENTIAL, SERVICE_UNIFORM or SERVICE_PARETO
+	long mean_interarrival;			// the mean time between two arrivals
+	long mean_service;				// the mean service time
+};
+
+/* Set the description of a workload to the defaults. */
+void default_workload_spec(struct workload_spec* spec);
+
+/* Write a synthetic workload to an input file. */
+int generate_workload(const struct workload_spec* spec, const char* output_path);
+
+/* The smallest throughput, in events per second, that "--verify" allows for any policy unless "--min-rate" says
+ * otherwise. It is several times below what the slowest policy reaches on a laptop, so only a real slowdown fails. */
+#define DEFAULT_MIN_RATE 1000000
+
+/* Representation of the description of a self-check of the simulator. */
+struct verify_spec {
+	int num_traces;					// the number of random traces to compare SPN and SRT against their references on
+	unsigned long seed;				// the seed of the random number generator
+	double min_rate;				// the smallest throughput allowed for any policy, in events per second, or 0
+									// not to measure it
+	const char* golden_dir;			// the directory holding the sample input and the known output of every policy
+};
+
+/* Check the schedules of the simulator against known ones and reference implementations. */
+int run_verification(const struct verify_spec* spec);
+
+/* Counters of the work done by a simulation, compiled in only when building with "make METRICS=1" (which
+ * defines ENABLE_METRICS), so that the hot paths pay nothing for them otherwise. Every thread has its own
+ * counters, so simulations running in parallel do not share them. */
+#ifdef ENABLE_METRICS
+#define METRICS_ENABLED 1
+
+struct metrics {
+	long ready_inserts;				// the number of processes added to a Ready state (arrivals and preemptions)
+	long heap_inserts;				// the number of entries added to a priority queue
+	long heap_comparisons;			// the number of comparisons made while adding entries to a priority queue
+	long heap_moves;				// the number of entries moved while adding entries to a priority queue
+	long context_switches;			// the number of times a process was dispatched
+	long preemptions;				// the number of times a running process was preempted
+	long max_ready_depth;			// the largest number of processes ever ready at once
+	double ready_depth_time;		// the number of ready processes integrated over time
+	long elapsed_time;				// the simulated time the integral covers
+};
+
+extern _Thread_local struct metrics current_metrics;
+
+/* Add to a counter. */
+#define METRIC_ADD(field, amount) (current_metrics.field += (amount))
+
+/* Record that a number of processes were ready for a duration of simulated time. */
+#define METRIC_READY_DEPTH(depth, duration) record_ready_depth((depth), (duration))
+
+/* Update the depth statistics of the Ready state. A depth that lasts no time, such as while the processes
+ * arriving at one time are added one by one, is not counted. */
+static inline void record_ready_depth(long depth, long duration) {
+	if (duration <= 0) {
+		return;
+	}
+	if (depth > current_metrics.max_ready_depth) {
+		current_metrics.max_ready_depth = depth;
+	}
+	current_metrics.ready_depth_time += (double) depth * duration;
+	current_metrics.elapsed_time += duration;
+}
+#else
+#define METRICS_ENABLED 0
+#define METRIC_ADD(field, amount) ((void) 0)
+#define METRIC_READY_DEPTH(depth, duration) ((void) 0)
+#endif
+
+/* The formats of the metrics report. */
+#define METRICS_JSON 0
+#define METRICS_CSV 1
+
+/* Representation of the figures of a run reported together with the counters. */
+struct run_report {
+	const char* policy;				// the name of the scheduling policy
+	int num_cpus;					// the number of CPUs simulated
+	long num_processes;				// the number of processes that completed
+	long num_events;				// the number of completions and preemptions
+	double parse_seconds;			// the time spent reading the input (0 when streaming)
+	double simulate_seconds;		// the time spent simulating, including the output
+	long num_allocations;			// the number of calls to malloc() made by the memory pool of the run
+	size_t allocated_bytes;			// the number of bytes requested from malloc() by that memory pool
+};
+
+/* Reset the counters of the calling thread. */
+void reset_metrics();
+
+/* Write the counters of the calling thread and the figures of a run as JSON or CSV. */
+void write_metrics_report(FILE* stream, int format, const struct run_report* report);
+
+/* Representation of a simulation context, through which a program that links with libmydispatcher.a loads a
+ * trace of processes from memory and simulates policies over it as often as needed. */
+struct sim_context;
+
+/* Representation of what one simulation in a simulation context should do. */
+struct sim_request {
+	const char* policy;				// the name of the scheduling policy, such as "SRT"
+	struct policy_params params;	// the parameters of the policy
+	int num_cpus;					// the number of CPUs to simulate
+	int queue_mode;					// how the CPUs share the processes (multi-CPU simulations only)
+	int percentiles;				// how percentiles are worked out, or -1 if they are not needed
+	int keep_processes;				// whether the result of every process is kept
+};
+
+/* Representation of the results of one simulation in a simulation context. The arrays it points to belong to
+ * the context and stay valid until the context is used again. */
+struct sim_report {
+	int num_processes;						// the number of processes that completed
+	long num_events;						// the number of completions and preemptions
+	double average_turnaround;				// the average turnaround time (0 if no process completed)
+	double average_normalized_turnaround;	// the average normalized turnaround time
+	double average_waiting;					// the average waiting time
+	struct latency_summary latency;			// the percentiles, if they were asked for
+	struct smp_results cpus;				// the statistics of every CPU (multi-CPU simulations only)
+	const struct process_result* processes;	// the result of every process in order of completion, if they
+											// were asked to be kept, or NULL
+};
+
+/* Create a simulation context. */
+struct sim_context* create_sim_context();
+
+/* Set a simulation request to a single-CPU FCFS simulation with the default parameters. */
+void default_sim_request(struct sim_request* request);
+
+/* Load a trace of processes, in the format of an input file, into a simulation context. */
+int sim_context_load(struct sim_context* context, const char* trace, size_t trace_size);
+
+/* Simulate a scheduling policy over the trace loaded into a simulation context. */
+int sim_context_run(struct sim_context* context, const struct sim_request* request, struct sim_report* report);
 
-/* Create a list of processes from the data in an input file. */
-struct queue* read_input(FILE* input_file);
+/* Forget the trace and results of a simulation context, keeping its memory for reuse. */
+void sim_context_reset(struct sim_context* context);
 
-/* Produce the results of the SPN scheduling policy. */
-void spn(struct queue* process_list, FILE* output_file);
+/* Get the message of the last error of a simulation context. */
+const char* sim_context_error(struct sim_context* context);
 
-/* Produce the results of the SRT scheduling policy. */
-void srt(struct queue* process_list, FILE* output_file);
+/* Deallocate a simulation context together with everything it holds. */
+void destroy_sim_context(struct sim_context* context);
@@ -0,0 +1,283 @@
+/**
+ * Implementation of the simulation loop shared by all scheduling policies. The loop moves the clock from one
+ * interesting time to the next (an arrival, a completion or the end of a time slice), does all the
+ * accounting and output, and asks the policy whenever a scheduling decision has to be made.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include "mydispatcher.h"
+
+/* All available scheduling policies, searched by find_policy(). */
+static const struct policy* const all_policies[] = {
+	&fcfs_policy, &rr_policy, &spn_policy, &srt_policy, &hrrn_policy, &mlfq_policy
+};
+
+/*
+ * Set the parameters of the scheduling policies to their default values: a time quantum of 1 and 3 levels
+ * for MLFQ, with no priority boost, and no aging for SPN and SRT.
+ *
+ * params:	a pointer to the parameters to set
+ */
+void default_policy_params(struct policy_params* params) {
+	params->quantum = 1;
+	params->num_levels = 3;
+	params->boost_interval = 0;
+	params->aging_interval = 0;
+}
+
+/*
+ * Find a scheduling policy by its name.
+ *
+ * name:	the name of the policy, such as "SRT"
+ *
+ * Returns: a pointer to the policy, or NULL if there is no policy with that name
+ */
+const struct policy* find_policy(const char* name) {
+	for (size_t i = 0; i < sizeof(all_policies) / sizeof(all_policies[0]); i++) {
+		if (strcmp(all_policies[i]->name, name) == 0) {
+			return all_policies[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Work out when the number of ready processes next changes before a specified time because of an arrival. A
+ * policy that arrivals cannot preempt lets the clock run past arrivals, which are only added to the Ready state
+ * afterwards, so the depth statistics of the Ready state are recorded piecewise up to each of them.
+ *
+ * arrivals:	a pointer to the stream of processes
+ * time:		the time the clock moves to
+ *
+ * Returns: the arrival time of the next process if it arrives before the specified time, or that time otherwise
+ */
+static inline long next_depth_change(const struct arrival_stream* arrivals, long time) {
+	if (has_arrival(arrivals) && next_arrival_time(arrivals) < time) {
+		return next_arrival_time(arrivals);
+	}
+	return time;
+}
+
+/*
+ * Produce the results of a specified scheduling policy for a specified stream of processes.
+ *
+ * policy:		a pointer to the scheduling policy
+ * params:		a pointer to the parameters of the policy
+ * arrivals:	a pointer to the stream of processes to be scheduled, in order of arrival time
+ * output:		a pointer to the output writer to write results to
+ * pool:		a pointer to the memory pool used for the Ready state of the policy
+ * results:		a pointer to where the totals needed for the averages are stored
+ */
+void simulate(const struct policy* policy, const struct policy_params* params, struct arrival_stream* arrivals, struct output_writer* output, struct arena* pool, struct sim_results* results) {
+	struct process_table* table = arrivals->table;					// hold the table the processes are in
+
+	/* Hold the total turnaround time, normalized turnaround time and waiting time of all processes to
+	 * calculate the averages after all processes have been scheduled. */
+	results->num_processes = 0;
+	memset(&results->sum_turnaround, 0, sizeof(struct compensated_sum));
+	memset(&results->sum_normalized_turnaround, 0, sizeof(struct compensated_sum));
+	memset(&results->sum_waiting, 0, sizeof(struct compensated_sum));
+	results->num_events = 0;
+
+	/* Continue only if the stream of processes is not empty. */
+	if (!has_arrival(arrivals)) {
+		return;
+	}
+
+	/* Create the Ready state of the policy. Initialize the current time to be the arrival time of the first
+	 * process in the stream, which should be the earliest arriving process. Create a variable for the index
+	 * of the process in the Running state (-1 if there is none), a variable to hold the time a process is
+	 * dispatched and a variable to hold the time its time slice ends (-1 if it is unlimited). */
+	void* ready = policy->create(params, pool);
+	long current_time = next_arrival_time(arrivals);
+	int running_process = -1;
+	long start_time = 0;
+	long slice_end = -1;
+
+	/* When resuming from a checkpoint, carry on from the state it holds instead. */
+	struct checkpointer* checkpoint = results->checkpoint;
+	if (checkpoint != NULL && checkpoint->resume_file != NULL) {
+		struct sim_snapshot snapshot;
+		if (load_checkpoint(checkpoint, policy, ready, arrivals, &snapshot, results) != 0) {
+			checkpoint->error = 1;
+			return;
+		}
+		current_time = snapshot.current_time;
+		running_process = snapshot.running_process;
+		start_time = snapshot.start_time;
+		slice_end = snapshot.slice_end;
+	}
+
+	/* A what-if re-simulation carries on from a snapshot of the original simulation in the same way. */
+	struct what_if* what_if = results->what_if;
+	if (what_if != NULL && what_if->resume != NULL) {
+		struct sim_snapshot snapshot;
+		if (resume_what_if(what_if, policy, ready, arrivals, &snapshot, results) != 0) {
+			return;
+		}
+		current_time = snapshot.current_time;
+		running_process = snapshot.running_process;
+		start_time = snapshot.start_time;
+		slice_end = snapshot.slice_end;
+	}
+
+	while (1) {
+		if (checkpoint != NULL && checkpoint_due(checkpoint)) {
+			/* Every so often, write the whole state to a checkpoint. */
+			struct sim_snapshot snapshot = { current_time, running_process, start_time, slice_end };
+			save_checkpoint(checkpoint, policy, params, ready, arrivals, output, &snapshot, results);
+		}
+		if (what_if != NULL && what_if_snapshot_due(what_if)) {
+			/* The original simulation of a what-if analysis keeps a snapshot in memory every so often. */
+			struct sim_snapshot snapshot = { current_time, running_process, start_time, slice_end };
+			take_what_if_snapshot(what_if, policy, ready, arrivals, &snapshot, results);
+		}
+
+		if (has_arrival(arrivals) && next_arrival_time(arrivals) <= current_time) {
+			/* First, hand all processes that have arrived by the current time to the policy as one batch and
+			 * remove such processes from the stream, so that the policy makes a single decision about them
+			 * afterwards. A policy that cannot be preempted by arrivals lets the clock run past them, and
+			 * they are added as soon as the running process stops. */
+			do {
+				int arrived_process = take_arrival(arrivals);
+				write_arrival(output, table->id[arrived_process], table->arrival_time[arrived_process]);
+				policy->add_ready(ready, table, arrived_process, current_time);
+				METRIC_ADD(ready_inserts, 1);
+				METRIC_READY_DEPTH(policy->num_ready(ready), next_depth_change(arrivals, current_time) - table->arrival_time[arrived_process]);
+				if (results->latency != NULL) {
+					latency_ready(results->latency, table, arrived_process, table->arrival_time[arrived_process]);
+				}
+			} while (has_arrival(arrivals) && next_arrival_time(arrivals) <= current_time);
+
+		} else if (running_process == -1) {
+			/* If there is no running process and no process to be added: */
+
+			if (policy->num_ready(ready) > 0) {
+				/* If some process is ready, dispatch the one chosen by the policy. Store the current time as
+				 * the time this process is dispatched, and work out when its time slice ends. */
+				running_process = policy->select_next(ready, table, current_time);
+				METRIC_ADD(context_switches, 1);
+				if (results->latency != NULL) {
+					latency_dispatch(results->latency, table, running_process, current_time);
+				}
+				start_time = current_time;
+				slice_end = slice_end_time(current_time, policy->time_slice(ready, table, running_process));
+
+			} else if (has_arrival(arrivals)) {
+				/* A what-if re-simulation stops once it is idle where the original simulation was idle too,
+				 * since everything from there on is the same as in the original simulation. */
+				if (what_if != NULL && what_if_converged(what_if, arrivals->next, current_time)) {
+					break;
+				}
+
+				/* If no process is ready but there still exists some process in the stream (that is not yet
+				 * scheduled), set the current time to the arrival time of the next process in the stream,
+				 * since nothing can happen until that time. The CPU is idle meanwhile. */
+				METRIC_READY_DEPTH(0, next_arrival_time(arrivals) - current_time);
+				write_idle(output, current_time, next_arrival_time(arrivals), -1);
+				current_time = next_arrival_time(arrivals);
+
+			} else {
+				/* If the stream is also empty, then all processes have been scheduled. */
+				break;
+			}
+		} else {
+			/* If there is a running process and no process to be added: */
+			int slice_expired = slice_end != -1 && current_time >= slice_end;
+
+			if (table->remaining_time[running_process] == 0) {
+				/* If the remaining time of the running process is 0, it completes its execution at this time.
+				 * Calculate the turnaround time and waiting time of the completed process, then write the
+				 * needed information to the output. */
+				long turnaround_time = current_time - table->arrival_time[running_process];
+				long waiting_time = turnaround_time - table->service_time[running_process];
+				write_completion(output, table->id[running_process], start_time, current_time, table->arrival_time[running_process], table->service_time[running_process], -1);
+
+				/* Add the turnaround time, normalized turnaround time and waiting time to the total to
+				 * calculate the averages later. */
+				results->num_processes++;
+				add_to_sum(&results->sum_turnaround, turnaround_time);
+				add_to_sum(&results->sum_normalized_turnaround, ((double) turnaround_time) / table->service_time[running_process]);
+				add_to_sum(&results->sum_waiting, waiting_time);
+				results->num_events++;
+				if (results->latency != NULL) {
+					latency_complete(results->latency, waiting_time, turnaround_time);
+				}
+
+				/* Release the row of the completed process and set the running process to -1. */
+				finish_arrival(arrivals, running_process);
+				running_process = -1;
+
+			} else if (policy->should_preempt(ready, table, running_process, slice_expired, current_time)) {
+				/* If the policy decides to preempt the running process, give it back to the policy after
+				 * writing the needed information to the output. Then, dispatch the process chosen by the
+				 * policy and store the current time as the time this process is dispatched. */
+				write_preemption(output, table->id[running_process], start_time, current_time, -1);
+				results->num_events++;
+				policy->preempt(ready, table, running_process, slice_expired, current_time);
+				METRIC_ADD(preemptions, 1);
+				METRIC_ADD(ready_inserts, 1);
+				if (results->latency != NULL) {
+					latency_ready(results->latency, table, running_process, current_time);
+				}
+				running_process = policy->select_next(ready, table, current_time);
+				METRIC_ADD(context_switches, 1);
+				if (results->latency != NULL) {
+					latency_dispatch(results->latency, table, running_process, current_time);
+				}
+				start_time = current_time;
+				slice_end = slice_end_time(current_time, policy->time_slice(ready, table, running_process));
+
+			} else if (slice_expired) {
+				/* If the time slice has ended but the policy keeps the running process, give it a new time
+				 * slice without dispatching it again. */
+				slice_end = slice_end_time(current_time, policy->time_slice(ready, table, running_process));
+
+			} else {
+				/* Otherwise, skip to the next time something can happen: the running process finishes, its
+				 * time slice ends, or (if the policy can be preempted by arrivals) the next process arrives,
+				 * whichever is earliest. Update the remaining time of the running process accordingly. */
+				long next_time = current_time + table->remaining_time[running_process];
+				if (slice_end != -1 && slice_end < next_time) {
+					next_time = slice_end;
+				}
+				if (policy->preempt_on_arrival && has_arrival(arrivals) && next_arrival_time(arrivals) <= next_time) {
+					next_time = next_arrival_time(arrivals);
+				}
+				table->remaining_time[running_process] -= next_time - current_time;
+				METRIC_READY_DEPTH(policy->num_ready(ready), next_depth_change(arrivals, next_time) - current_time);
+				current_time = next_time;
+			}
+		}
+	}
+}
+
+/*
+ * Print out the average turnaround time, average normalized turnaround time and average waiting time across
+ * all processes of a simulation. Nothing is printed out if no process was scheduled.
+ *
+ * results:	a pointer to the results of the simulation
+ */
+void print_averages(const struct sim_results* results) {
+	write_averages(stdout, results);
+}
+
+/*
+ * Write the averages of a simulation to a stream, in the same way print_averages() prints them out.
+ *
+ * stream:	the stream to write to
+ * results:	a pointer to the results of the simulation
+ */
+void write_averages(FILE* stream, const struct sim_results* results) {
+	if (results->num_processes > 0) {
+		fprintf(stream, "Average turnaround time = %f\n", sum_value(&results->sum_turnaround)/results->num_processes);
+		fprintf(stream, "Average normalized turnaround time = %f\n", sum_value(&results->sum_normalized_turnaround)/results->num_processes);
+		fprintf(stream, "Average waiting time = %f\n", sum_value(&results->sum_waiting)/results->num_processes);
+	}
+}
@@ -0,0 +1,146 @@
+/**
+ * Implementation of a generator of synthetic workloads, which writes input files of any length with arrival
+ * times drawn from a Poisson or a bursty arrival process and service times drawn from an exponential, a
+ * uniform or a heavy-tailed (Pareto) distribution. The same seed always gives the same workload.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <limits.h>
+#include <math.h>
+#include "mydispatcher.h"
+
+/* The average number of processes in a burst of the bursty arrival process. */
+#define BURST_SIZE 16
+
+/* How much shorter the time between arrivals is within a burst than on average. */
+#define BURST_SPEEDUP 10
+
+/* The shape of the Pareto distribution of service times; the smaller it is, the heavier the tail. */
+#define PARETO_SHAPE 1.5
+
+/* The largest service time the Pareto distribution can give, as a multiple of the mean service time. */
+#define PARETO_CAP 10000
+
+/*
+ * Get a random number uniformly distributed strictly between 0 and 1.
+ *
+ * state:	a pointer to the state of the generator
+ *
+ * Returns: the random number
+ */
+static double next_uniform(uint64_t* state) {
+	return ((next_random(state) >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/*
+ * Get a random number that is exponentially distributed.
+ *
+ * state:	a pointer to the state of the generator
+ * mean:	the mean of the distribution
+ *
+ * Returns: the random number
+ */
+static double next_exponential(uint64_t* state, double mean) {
+	return -mean * log(next_uniform(state));
+}
+
+/*
+ * Get the service time of the next process, which is at least 1.
+ *
+ * spec:	a pointer to the description of the workload
+ * state:	a pointer to the state of the generator
+ *
+ * Returns: the service time
+ */
+static long next_service_time(const struct workload_spec* spec, uint64_t* state) {
+	double service_time;
+	if (spec->service_distribution == SERVICE_UNIFORM) {
+		/* Uniform on 1 to 2 * mean - 1, so that the mean is as requested. */
+		return 1 + (long) (next_random(state) % (2 * (uint64_t) spec->mean_service - 1));
+	} else if (spec->service_distribution == SERVICE_PARETO) {
+		/* Pareto with the scale chosen so that the mean is as requested, truncated so that a single process
+		 * cannot take over the whole simulation. */
+		double scale = spec->mean_service * (PARETO_SHAPE - 1) / PARETO_SHAPE;
+		service_time = scale / pow(next_uniform(state), 1 / PARETO_SHAPE);
+		if (service_time > (double) spec->mean_service * PARETO_CAP) {
+			service_time = (double) spec->mean_service * PARETO_CAP;
+		}
+	} else {
+		service_time = next_exponential(state, spec->mean_service);
+	}
+	if (service_time >= (double) LONG_MAX) {
+		return LONG_MAX;
+	}
+	return service_time < 1 ? 1 : (long) ceil(service_time);
+}
+
+/*
+ * Set the description of a workload to the defaults: 1000 processes arriving as a Poisson process 4 time
+ * units apart on average, with exponentially distributed service times of 3 time units on average.
+ *
+ * spec:	a pointer to the description of the workload
+ */
+void default_workload_spec(struct workload_spec* spec) {
+	spec->num_processes = 1000;
+	spec->seed = 1;
+	spec->arrival_process = ARRIVALS_POISSON;
+	spec->service_distribution = SERVICE_EXPONENTIAL;
+	spec->mean_interarrival = 4;
+	spec->mean_service = 3;
+}
+
+/*
+ * Write a synthetic workload to an input file. If the file cannot be written or the arrival times do not fit
+ * in a long, an error statement is printed out.
+ *
+ * spec:		a pointer to the description of the workload
+ * output_path:	the path of the input file to write
+ *
+ * Returns: 0 on success, -1 if an error occurs
+ */
+int generate_workload(const struct workload_spec* spec, const char* output_path) {
+	FILE* output_file = fopen(output_path, "w");
+	if (output_file == NULL) {
+		printf("ERROR: Cannot open/create file \"%s\"\n", output_path);
+		return -1;
+	}
+	setvbuf(output_file, NULL, _IOFBF, 1 << 20);
+
+	/* In the bursty arrival process, processes arrive in bursts of BURST_SIZE on average, BURST_SPEEDUP
+	 * times faster than on average within a burst; the gaps between bursts make up for it, so that the
+	 * overall arrival rate is the same as for the Poisson process. */
+	double burst_interarrival = (double) spec->mean_interarrival / BURST_SPEEDUP;
+	double burst_gap = (double) spec->mean_interarrival * BURST_SIZE - burst_interarrival * (BURST_SIZE - 1);
+
+	uint64_t state = spec->seed;
+	double clock = 0;
+	int result = 0;
+	for (long i = 0; i < spec->num_processes; i++) {
+		if (i > 0) {
+			if (spec->arrival_process == ARRIVALS_BURSTY) {
+				/* Each arrival ends the current burst with probability 1 / BURST_SIZE. */
+				int ends_burst = next_random(&state) % BURST_SIZE == 0;
+				clock += next_exponential(&state, ends_burst ? burst_gap : burst_interarrival);
+			} else {
+				clock += next_exponential(&state, spec->mean_interarrival);
+			}
+		}
+		if (clock >= (double) LONG_MAX) {
+			printf("ERROR: The arrival times of %ld processes do not fit in a long!\n", spec->num_processes);
+			result = -1;
+			break;
+		}
+		fprintf(output_file, "%ld %ld\n", (long) clock, next_service_time(spec, &state));
+	}
+
+	if (fclose(output_file) != 0 && result == 0) {
+		printf("ERROR: Cannot write file \"%s\"\n", output_path);
+		result = -1;
+	}
+	return result;
+}
@@ -0,0 +1,257 @@
+/**
+ * Implementation of the distributions of waiting and turnaround times, which give the percentiles (p50, p95,
+ * p99 and p99.9) and maxima of a simulation on top of the averages. By default the values go into log-linear
+ * (HDR-style) histograms, which take the same memory for any number of processes and are exact below 256
+ * and within 1% above; optionally every value is kept and the percentiles are exact. The longest time any
+ * process waited in the Ready state in one stretch (its starvation) is kept as well.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include "mydispatcher.h"
+
+/* The percentiles reported, in tenths of a percent. */
+static const int PERCENTILES[NUM_PERCENTILES] = { 500, 950, 990, 999 };
+
+/* The names of the percentiles reported. */
+static const char* const PERCENTILE_NAMES[NUM_PERCENTILES] = { "p50", "p95", "p99", "p99.9" };
+
+/*
+ * Find the histogram bucket of a value. Values below 2^(HISTOGRAM_SUB_BITS + 1) get a bucket each; larger
+ * values share a bucket with the others that have the same HISTOGRAM_SUB_BITS + 1 leading bits.
+ *
+ * value:	the non-negative value
+ *
+ * Returns: the index of the bucket
+ */
+static int histogram_bucket(long value) {
+	if (value < (2 << HISTOGRAM_SUB_BITS)) {
+		return (int) value;
+	}
+	int shift = (63 - __builtin_clzl((unsigned long) value)) - HISTOGRAM_SUB_BITS;
+	return (shift << HISTOGRAM_SUB_BITS) + (int) (value >> shift);
+}
+
+/*
+ * Get the largest value that falls into a histogram bucket.
+ *
+ * bucket:	the index of the bucket
+ *
+ * Returns: the largest value of the bucket
+ */
+static long histogram_bucket_max(int bucket) {
+	if (bucket < (2 << HISTOGRAM_SUB_BITS)) {
+		return bucket;
+	}
+	int shift = (bucket >> HISTOGRAM_SUB_BITS) - 1;
+	unsigned long mantissa = bucket - ((long) shift << HISTOGRAM_SUB_BITS);
+	return (long) (((mantissa + 1) << shift) - 1);
+}
+
+/*
+ * Get the position of a percentile among a number of sorted values (the nearest-rank definition).
+ *
+ * total:		the number of values
+ * percentile:	the percentile in tenths of a percent
+ *
+ * Returns: the number of values up to and including the percentile, from 1 to total
+ */
+static long percentile_rank(long total, int percentile) {
+	long rank = (total * percentile + 999) / 1000;
+	return rank < 1 ? 1 : rank;
+}
+
+/*
+ * Work out the percentiles of the values in a histogram. A percentile is reported as the largest value of
+ * its bucket, but never more than the largest value seen.
+ *
+ * current_histogram:	a pointer to the histogram
+ * percentiles:			an array of NUM_PERCENTILES elements where the percentiles are stored
+ */
+static void histogram_percentiles(const struct histogram* current_histogram, long* percentiles) {
+	long seen = 0;
+	int bucket = 0;
+	for (int i = 0; i < NUM_PERCENTILES; i++) {
+		long rank = percentile_rank(current_histogram->total, PERCENTILES[i]);
+		while (seen + current_histogram->counts[bucket] < rank) {
+			seen += current_histogram->counts[bucket];
+			bucket++;
+		}
+		long value = histogram_bucket_max(bucket);
+		percentiles[i] = value < current_histogram->max ? value : current_histogram->max;
+	}
+}
+
+/*
+ * Compare two longs for qsort().
+ */
+static int compare_longs(const void* first, const void* second) {
+	long a = *(const long*) first;
+	long b = *(const long*) second;
+	return (a > b) - (a < b);
+}
+
+/*
+ * Work out the exact percentiles of an array of values, which is sorted in the process.
+ *
+ * values:			the array of values
+ * num_values:		the number of values
+ * percentiles:		an array of NUM_PERCENTILES elements where the percentiles are stored
+ */
+static void exact_percentiles(long* values, long num_values, long* percentiles) {
+	qsort(values, num_values, sizeof(long), compare_longs);
+	for (int i = 0; i < NUM_PERCENTILES; i++) {
+		percentiles[i] = values[percentile_rank(num_values, PERCENTILES[i]) - 1];
+	}
+}
+
+/*
+ * Create the state for collecting the distributions of waiting and turnaround times.
+ *
+ * mode:	PERCENTILES_HISTOGRAM or PERCENTILES_EXACT
+ * pool:	a pointer to the memory pool the state is taken from
+ *
+ * Returns: a pointer to the state
+ */
+struct latency_stats* create_latency_stats(int mode, struct arena* pool) {
+	struct latency_stats* stats = (struct latency_stats*) arena_alloc(pool, sizeof(struct latency_stats));
+	memset(stats, 0, sizeof(struct latency_stats));
+	stats->mode = mode;
+	stats->starved_id = -1;
+	stats->pool = pool;
+
+	/* Start with small arrays, which are grown whenever they become too small. */
+	stats->ready_since_capacity = 16;
+	stats->ready_since = (long*) arena_alloc(pool, stats->ready_since_capacity * sizeof(long));
+	if (mode == PERCENTILES_EXACT) {
+		stats->exact_capacity = 1024;
+		stats->exact_waiting = (long*) arena_alloc(pool, stats->exact_capacity * sizeof(long));
+		stats->exact_turnaround = (long*) arena_alloc(pool, stats->exact_capacity * sizeof(long));
+	}
+	return stats;
+}
+
+/*
+ * Record that a process became ready (arrived, or was preempted) at a specified time.
+ *
+ * stats:	a pointer to the state
+ * table:	a pointer to the table the process is in
+ * process:	the index of the process
+ * time:	the time the process became ready
+ */
+void latency_ready(struct latency_stats* stats, const struct process_table* table, int process, long time) {
+	if (stats->ready_since_capacity < table->capacity) {
+		/* If the process table has grown, grow the array with it. */
+		stats->ready_since = (long*) arena_grow(stats->pool, stats->ready_since, stats->ready_since_capacity * sizeof(long), table->capacity * sizeof(long));
+		stats->ready_since_capacity = table->capacity;
+	}
+	stats->ready_since[process] = time;
+}
+
+/*
+ * Record that a process was dispatched at a specified time, which ends a stretch of waiting in the Ready
+ * state.
+ *
+ * stats:	a pointer to the state
+ * table:	a pointer to the table the process is in
+ * process:	the index of the process
+ * now:		the time the process was dispatched
+ */
+void latency_dispatch(struct latency_stats* stats, const struct process_table* table, int process, long now) {
+	long stretch = now - stats->ready_since[process];
+	if (stretch > stats->max_starvation || stats->starved_id == -1) {
+		stats->max_starvation = stretch;
+		stats->starved_id = table->id[process];
+	}
+}
+
+/*
+ * Add a value to a histogram.
+ *
+ * current_histogram:	a pointer to the histogram
+ * value:				the non-negative value
+ */
+static void histogram_add(struct histogram* current_histogram, long value) {
+	current_histogram->counts[histogram_bucket(value)]++;
+	current_histogram->total++;
+	if (value > current_histogram->max) {
+		current_histogram->max = value;
+	}
+}
+
+/*
+ * Record the waiting and turnaround times of a completed process.
+ *
+ * stats:		a pointer to the state
+ * waiting:		the waiting time of the process
+ * turnaround:	the turnaround time of the process
+ */
+void latency_complete(struct latency_stats* stats, long waiting, long turnaround) {
+	histogram_add(&stats->waiting, waiting);
+	histogram_add(&stats->turnaround, turnaround);
+	if (stats->mode == PERCENTILES_EXACT) {
+		if (stats->num_exact == stats->exact_capacity) {
+			/* If the arrays are full, double their capacity. */
+			long capacity = 2 * stats->exact_capacity;
+			stats->exact_waiting = (long*) arena_grow(stats->pool, stats->exact_waiting, stats->exact_capacity * sizeof(long), capacity * sizeof(long));
+			stats->exact_turnaround = (long*) arena_grow(stats->pool, stats->exact_turnaround, stats->exact_capacity * sizeof(long), capacity * sizeof(long));
+			stats->exact_capacity = capacity;
+		}
+		stats->exact_waiting[stats->num_exact] = waiting;
+		stats->exact_turnaround[stats->num_exact] = turnaround;
+		stats->num_exact++;
+	}
+}
+
+/*
+ * Work out the percentiles and maxima of the collected distributions.
+ *
+ * stats:		a pointer to the state
+ * summary:		a pointer to where the percentiles and maxima are stored
+ */
+void summarize_latency(struct latency_stats* stats, struct latency_summary* summary) {
+	memset(summary, 0, sizeof(struct latency_summary));
+	summary->count = stats->waiting.total;
+	summary->max_waiting = stats->waiting.max;
+	summary->max_turnaround = stats->turnaround.max;
+	summary->max_starvation = stats->max_starvation;
+	summary->starved_id = stats->starved_id;
+	if (summary->count == 0) {
+		return;
+	}
+	if (stats->mode == PERCENTILES_EXACT) {
+		exact_percentiles(stats->exact_waiting, stats->num_exact, summary->waiting);
+		exact_percentiles(stats->exact_turnaround, stats->num_exact, summary->turnaround);
+	} else {
+		histogram_percentiles(&stats->waiting, summary->waiting);
+		histogram_percentiles(&stats->turnaround, summary->turnaround);
+	}
+}
+
+/*
+ * Print out the percentiles and maxima of the waiting and turnaround times, and the longest stretch a
+ * process waited in the Ready state. Nothing is printed out if no process was scheduled.
+ *
+ * summary:	a pointer to the percentiles and maxima
+ */
+void print_latency_summary(const struct latency_summary* summary) {
+	if (summary->count == 0) {
+		return;
+	}
+	printf("Waiting time:");
+	for (int i = 0; i < NUM_PERCENTILES; i++) {
+		printf(" %s = %ld,", PERCENTILE_NAMES[i], summary->waiting[i]);
+	}
+	printf(" max = %ld\n", summary->max_waiting);
+	printf("Turnaround time:");
+	for (int i = 0; i < NUM_PERCENTILES; i++) {
+		printf(" %s = %ld,", PERCENTILE_NAMES[i], summary->turnaround[i]);
+	}
+	printf(" max = %ld\n", summary->max_turnaround);
+	printf("Longest wait in the Ready state = %ld (process %d)\n", summary->max_starvation, summary->starved_id);
+}
@@ -0,0 +1,73 @@
+/**
+ * Implementation of the metrics report, which shows how much work a simulation did: how many processes went
+ * through the Ready state and what adding them cost, how deep the Ready state got, how often processes were
+ * preempted and dispatched, how much memory was allocated and how fast events were simulated. The counters
+ * behind it only exist in builds made with "make METRICS=1".
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include "mydispatcher.h"
+
+#ifdef ENABLE_METRICS
+/* The counters of the calling thread. */
+_Thread_local struct metrics current_metrics;
+#endif
+
+/*
+ * Reset the counters of the calling thread to 0. Does nothing if the counters are not compiled in.
+ */
+void reset_metrics() {
+#ifdef ENABLE_METRICS
+	memset(&current_metrics, 0, sizeof(current_metrics));
+#endif
+}
+
+/*
+ * Write the counters of the calling thread together with the figures of a run, either as a JSON object or as
+ * a CSV header line followed by a line of values. Should only be called if the counters are compiled in.
+ *
+ * stream:	the stream to write to
+ * format:	METRICS_JSON or METRICS_CSV
+ * report:	a pointer to the figures of the run
+ */
+void write_metrics_report(FILE* stream, int format, const struct run_report* report) {
+#ifdef ENABLE_METRICS
+	const struct metrics* counters = &current_metrics;
+	double events_per_second = report->simulate_seconds > 0 ? report->num_events / report->simulate_seconds : 0;
+	double mean_ready_depth = counters->elapsed_time > 0 ? counters->ready_depth_time / counters->elapsed_time : 0;
+	double comparisons_per_insert = counters->heap_inserts > 0 ? (double) counters->heap_comparisons / counters->heap_inserts : 0;
+
+	if (format == METRICS_CSV) {
+		fprintf(stream, "policy,cpus,processes,events,parse_seconds,simulate_seconds,events_per_second,ready_inserts,heap_inserts,heap_comparisons,heap_moves,comparisons_per_insert,max_ready_depth,mean_ready_depth,preemptions,context_switches,allocations,allocated_bytes\n");
+		fprintf(stream, "%s,%d,%ld,%ld,%f,%f,%f,%ld,%ld,%ld,%ld,%f,%ld,%f,%ld,%ld,%ld,%zu\n", report->policy, report->num_cpus, report->num_processes, report->num_events, report->parse_seconds, report->simulate_seconds, events_per_second, counters->ready_inserts, counters->heap_inserts, counters->heap_comparisons, counters->heap_moves, comparisons_per_insert, counters->max_ready_depth, mean_ready_depth, counters->preemptions, counters->context_switches, report->num_allocations, report->allocated_bytes);
+		return;
+	}
+
+	fprintf(stream, "{\n");
+	fprintf(stream, "  \"policy\": \"%s\",\n", report->policy);
+	fprintf(stream, "  \"cpus\": %d,\n", report->num_cpus);
+	fprintf(stream, "  \"processes\": %ld,\n", report->num_processes);
+	fprintf(stream, "  \"events\": %ld,\n", report->num_events);
+	fprintf(stream, "  \"parse_seconds\": %f,\n", report->parse_seconds);
+	fprintf(stream, "  \"simulate_seconds\": %f,\n", report->simulate_seconds);
+	fprintf(stream, "  \"events_per_second\": %f,\n", events_per_second);
+	fprintf(stream, "  \"ready_inserts\": %ld,\n", counters->ready_inserts);
+	fprintf(stream, "  \"heap_inserts\": %ld,\n", counters->heap_inserts);
+	fprintf(stream, "  \"heap_comparisons\": %ld,\n", counters->heap_comparisons);
+	fprintf(stream, "  \"heap_moves\": %ld,\n", counters->heap_moves);
+	fprintf(stream, "  \"comparisons_per_insert\": %f,\n", comparisons_per_insert);
+	fprintf(stream, "  \"max_ready_depth\": %ld,\n", counters->max_ready_depth);
+	fprintf(stream, "  \"mean_ready_depth\": %f,\n", mean_ready_depth);
+	fprintf(stream, "  \"preemptions\": %ld,\n", counters->preemptions);
+	fprintf(stream, "  \"context_switches\": %ld,\n", counters->context_switches);
+	fprintf(stream, "  \"allocations\": %ld,\n", report->num_allocations);
+	fprintf(stream, "  \"allocated_bytes\": %zu\n", report->allocated_bytes);
+	fprintf(stream, "}\n");
+#endif
+}
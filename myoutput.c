@@ -0,0 +1,715 @@
+/**
+ * Implementation of the output stage of the scheduling program. Results are formatted straight into a large
+ * in-memory buffer, without going through stdio, and written to the output file in big chunks, optionally by
+ * a separate writer thread. Results can also be written as a compact binary event log, which can be converted
+ * back to the text format afterwards, or as a timeline of every run, arrival and idle interval in the Chrome
+ * trace-event JSON format, which is written as the simulation goes and opens in chrome://tracing or Perfetto.
+ * For programs that use the scheduler as a library, the results of the processes can also be kept in memory.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "mydispatcher.h"
+
+/* The size of each buffer of an output writer. */
+#define OUTPUT_BUFFER_SIZE (1024 * 1024)
+
+/* The largest number of bytes a single result can take in any format. */
+#define OUTPUT_RECORD_MAX 320
+
+/* The first bytes of a binary event log, followed by the format version. */
+static const char EVENT_LOG_MAGIC[8] = { 'M', 'Y', 'D', 'E', 'V', 'L', 'O', 'G' };
+#define EVENT_LOG_VERSION 3
+
+/* Kinds of records in a binary event log. */
+#define EVENT_COMPLETION 1		// a process ran until it completed
+#define EVENT_PREEMPTION 2		// a process ran until it was preempted
+
+/* The start of a timeline: the name of its only process and of the track of arrivals (track 0). Every event
+ * after it starts with a comma, so that the timeline can be written without looking back. */
+static const char TRACE_HEADER[] = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+	"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Scheduler\"}},\n"
+	"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Arrivals\"}}";
+
+/* The end of a timeline. */
+static const char TRACE_FOOTER[] = "\n]}\n";
+
+/* Representation of a record in a binary event log. All fields are stored in the byte order of the machine
+ * that wrote the log, and the times are 64-bit whatever the size of a long, so that the layout is the same on
+ * every machine of that byte order. The waiting time, finish time and turnaround time of a completion follow
+ * from the other fields. */
+struct event_record {
+	int32_t type;				// the kind of the record
+	int32_t id;					// the ID of the process
+	int64_t start;				// the time the process was dispatched
+	int64_t end;				// the time the process completed or was preempted
+	int64_t arrival;			// the arrival time of the process (completions only)
+	int64_t service;			// the service time of the process (completions only)
+	int32_t cpu;				// the CPU the process ran on, or -1 for a single-CPU simulation
+	int32_t unused;				// always 0, so that the record has no padding of undefined value
+};
+
+/*
+ * Write a whole buffer to a file descriptor, retrying after partial writes.
+ *
+ * fd:		the file descriptor to write to
+ * data:	a pointer to the bytes to write
+ * size:	the number of bytes to write
+ *
+ * Returns: 0 on success, -1 if an error occurs
+ */
+static int write_all(int fd, const char* data, size_t size) {
+	while (size > 0) {
+		ssize_t written = write(fd, data, size);
+		if (written < 0) {
+			return -1;
+		}
+		data += written;
+		size -= written;
+	}
+	return 0;
+}
+
+/*
+ * The function run by the writer thread of an output writer. It waits until a full buffer is handed over,
+ * writes it out, and hands the buffer back.
+ *
+ * argument:	a pointer to the output writer
+ *
+ * Returns: NULL
+ */
+static void* writer_thread_main(void* argument) {
+	struct output_writer* writer = (struct output_writer*) argument;
+	pthread_mutex_lock(&writer->lock);
+	while (1) {
+		while (writer->pending_size == 0 && !writer->stopping) {
+			pthread_cond_wait(&writer->changed, &writer->lock);
+		}
+		if (writer->pending_size == 0) {
+			/* Stopping, and everything handed over has been written. */
+			break;
+		}
+
+		/* Write the handed-over buffer without holding the lock, so that the scheduler can keep filling
+		 * the other buffer meanwhile. */
+		size_t size = writer->pending_size;
+		pthread_mutex_unlock(&writer->lock);
+		int result = write_all(writer->fd, writer->pending, size);
+		pthread_mutex_lock(&writer->lock);
+		if (result != 0) {
+			writer->error = 1;
+		}
+		writer->pending_size = 0;
+		pthread_cond_signal(&writer->changed);
+	}
+	pthread_mutex_unlock(&writer->lock);
+	return NULL;
+}
+
+/*
+ * Write out everything in the buffer of a specified output writer. With a writer thread, the buffer is
+ * swapped with the one the thread has finished writing and the thread writes it out in the background.
+ *
+ * writer:	a pointer to the output writer
+ */
+static void flush_output(struct output_writer* writer) {
+	if (writer->used == 0) {
+		return;
+	}
+	writer->size += writer->used;
+	if (!writer->threaded) {
+		if (write_all(writer->fd, writer->buffer, writer->used) != 0) {
+			writer->error = 1;
+		}
+	} else {
+		pthread_mutex_lock(&writer->lock);
+		while (writer->pending_size != 0) {
+			pthread_cond_wait(&writer->changed, &writer->lock);
+		}
+		char* written_buffer = writer->pending;
+		writer->pending = writer->buffer;
+		writer->pending_size = writer->used;
+		writer->buffer = written_buffer;
+		pthread_cond_signal(&writer->changed);
+		pthread_mutex_unlock(&writer->lock);
+	}
+	writer->used = 0;
+}
+
+/*
+ * Set up an output writer on a file that has been opened for writing.
+ *
+ * writer:		a pointer to the output writer, whose format field is set
+ * output_fd:	the file descriptor of the file
+ * threaded:	whether the file should be written by a separate writer thread
+ * pool:		a pointer to the memory pool that owns the buffers
+ */
+static void start_output_writer(struct output_writer* writer, int output_fd, int threaded, struct arena* pool) {
+	writer->fd = output_fd;
+	writer->buffer = (char*) arena_alloc(pool, OUTPUT_BUFFER_SIZE);
+	writer->used = 0;
+	writer->error = 0;
+	writer->threaded = threaded;
+	if (threaded) {
+		/* The writer thread gets a second buffer, so that formatting and writing overlap. */
+		writer->pending = (char*) arena_alloc(pool, OUTPUT_BUFFER_SIZE);
+		writer->pending_size = 0;
+		writer->stopping = 0;
+		pthread_mutex_init(&writer->lock, NULL);
+		pthread_cond_init(&writer->changed, NULL);
+		if (pthread_create(&writer->thread, NULL, writer_thread_main, writer) != 0) {
+			/* If no thread can be started, simply write from the calling thread. */
+			writer->threaded = 0;
+		}
+	}
+}
+
+/*
+ * Open an output writer on a specified file, which is created if it does not exist and emptied otherwise.
+ *
+ * output_path:	the path of the file to write to (unused for OUTPUT_NONE and OUTPUT_RECORDS)
+ * format:		OUTPUT_TEXT for the text format, OUTPUT_BINARY for a binary event log, OUTPUT_TRACE for a
+ *				timeline, OUTPUT_RECORDS to keep the result of every completed process in memory, or
+ *				OUTPUT_NONE to discard all results (for runs where only the averages are needed)
+ * threaded:	whether the file should be written by a separate writer thread
+ * pool:		a pointer to the memory pool that owns the output writer and its buffers
+ *
+ * Returns: a pointer to the output writer, or NULL if the file cannot be opened/created
+ */
+struct output_writer* open_output_writer(const char* output_path, int format, int threaded, struct arena* pool) {
+	struct output_writer* writer = (struct output_writer*) arena_alloc(pool, sizeof(struct output_writer));
+	writer->format = format;
+	writer->size = 0;
+	writer->trace = NULL;
+	writer->num_tracks = 0;
+	writer->records = NULL;
+	writer->num_records = 0;
+	writer->records_capacity = 0;
+	writer->pool = pool;
+	if (format == OUTPUT_NONE || format == OUTPUT_RECORDS) {
+		/* Nothing is ever written to a file, so there is no file, buffer or thread. */
+		writer->fd = -1;
+		writer->used = 0;
+		writer->error = 0;
+		writer->threaded = 0;
+		return writer;
+	}
+
+	int output_fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (output_fd < 0) {
+		return NULL;
+	}
+	start_output_writer(writer, output_fd, threaded, pool);
+
+	if (format == OUTPUT_BINARY) {
+		/* A binary event log starts with the magic bytes and the format version. */
+		memcpy(writer->buffer, EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC));
+		int version = EVENT_LOG_VERSION;
+		memcpy(writer->buffer + sizeof(EVENT_LOG_MAGIC), &version, sizeof(int));
+		writer->used = sizeof(EVENT_LOG_MAGIC) + sizeof(int);
+	} else if (format == OUTPUT_TRACE) {
+		memcpy(writer->buffer, TRACE_HEADER, sizeof(TRACE_HEADER) - 1);
+		writer->used = sizeof(TRACE_HEADER) - 1;
+	}
+	return writer;
+}
+
+/*
+ * Open an output writer that carries on writing a file that was written up to a specified size, such as the
+ * output of a simulation resumed from a checkpoint. Anything in the file after that size is removed.
+ *
+ * output_path:	the path of the file to write to
+ * format:		OUTPUT_TEXT or OUTPUT_BINARY
+ * threaded:	whether the file should be written by a separate writer thread
+ * size:		the number of bytes of the file to keep
+ * pool:		a pointer to the memory pool that owns the output writer and its buffers
+ *
+ * Returns: a pointer to the output writer, or NULL if the file cannot be opened or is shorter than size
+ */
+struct output_writer* reopen_output_writer(const char* output_path, int format, int threaded, long size, struct arena* pool) {
+	int output_fd = open(output_path, O_WRONLY);
+	if (output_fd < 0) {
+		return NULL;
+	}
+	if (lseek(output_fd, 0, SEEK_END) < size || ftruncate(output_fd, size) != 0 || lseek(output_fd, size, SEEK_SET) != size) {
+		close(output_fd);
+		return NULL;
+	}
+	struct output_writer* writer = (struct output_writer*) arena_alloc(pool, sizeof(struct output_writer));
+	writer->format = format;
+	writer->size = size;
+	writer->trace = NULL;
+	writer->num_tracks = 0;
+	writer->records = NULL;
+	writer->num_records = 0;
+	writer->records_capacity = 0;
+	writer->pool = pool;
+	start_output_writer(writer, output_fd, threaded, pool);
+	return writer;
+}
+
+/*
+ * Format an integer in decimal at a specified position.
+ *
+ * position:	a pointer to where the digits are written
+ * value:		the integer to format
+ *
+ * Returns: a pointer to the position after the last digit
+ */
+static char* format_int(char* position, long value) {
+	char digits[20];
+	int num_digits = 0;
+	unsigned long magnitude = value < 0 ? -(unsigned long) value : (unsigned long) value;
+	if (value < 0) {
+		*position++ = '-';
+	}
+
+	/* Produce the digits from the least significant one, then copy them in the right order. Dividing a 64-bit
+	 * integer is much slower than dividing a 32-bit one, so only the digits above the lowest 9 are produced
+	 * with 64-bit division, which most values never need. */
+	while (magnitude > UINT_MAX) {
+		unsigned int low = (unsigned int) (magnitude % 1000000000);
+		magnitude /= 1000000000;
+		for (int i = 0; i < 9; i++) {
+			digits[num_digits++] = '0' + low % 10;
+			low /= 10;
+		}
+	}
+	unsigned int small_magnitude = (unsigned int) magnitude;
+	do {
+		digits[num_digits++] = '0' + small_magnitude % 10;
+		small_magnitude /= 10;
+	} while (small_magnitude != 0);
+	while (num_digits > 0) {
+		*position++ = digits[--num_digits];
+	}
+	return position;
+}
+
+/*
+ * Copy a string without its terminating null character to a specified position.
+ *
+ * position:	a pointer to where the characters are written
+ * text:		the string to copy
+ *
+ * Returns: a pointer to the position after the last character
+ */
+static char* format_text(char* position, const char* text) {
+	while (*text != '\0') {
+		*position++ = *text++;
+	}
+	return position;
+}
+
+/*
+ * Make sure a specified output writer has room for one more result, flushing its buffer if needed.
+ *
+ * writer:	a pointer to the output writer
+ *
+ * Returns: a pointer to the free space in the buffer
+ */
+static char* reserve_output(struct output_writer* writer) {
+	if (OUTPUT_BUFFER_SIZE - writer->used < OUTPUT_RECORD_MAX) {
+		flush_output(writer);
+	}
+	return writer->buffer + writer->used;
+}
+
+/*
+ * Append a record to the binary event log of a specified output writer.
+ *
+ * writer:	a pointer to the output writer
+ * record:	a pointer to the record
+ */
+static void append_event(struct output_writer* writer, const struct event_record* record) {
+	char* position = reserve_output(writer);
+	memcpy(position, record, sizeof(struct event_record));
+	writer->used += sizeof(struct event_record);
+}
+
+/*
+ * Format where a process ran, "<id> runs <start>-<end>", followed by " on CPU <cpu>" in a multi-CPU
+ * simulation.
+ *
+ * position:	a pointer to where the text is written
+ * id:			the ID of the process
+ * start:		the time the process was dispatched
+ * end:			the time the process completed or was preempted
+ * cpu:			the CPU the process ran on, or -1 for a single-CPU simulation
+ *
+ * Returns: a pointer to the position after the last character
+ */
+static char* format_run(char* position, int id, long start, long end, int cpu) {
+	position = format_int(position, id);
+	position = format_text(position, " runs ");
+	position = format_int(position, start);
+	*position++ = '-';
+	position = format_int(position, end);
+	if (cpu >= 0) {
+		position = format_text(position, " on CPU ");
+		position = format_int(position, cpu);
+	}
+	return position;
+}
+
+/*
+ * Get the track of a timeline that holds the runs and idle intervals of a CPU, naming it (and any track
+ * before it that has not been named yet) the first time it is used. Track 0 holds the arrivals, so the track
+ * of CPU k is k + 1, and the only CPU of a single-CPU simulation gets track 1.
+ *
+ * writer:	a pointer to the output writer of the timeline
+ * cpu:		the number of the CPU, or -1 for a single-CPU simulation
+ *
+ * Returns: the number of the track
+ */
+static int trace_track(struct output_writer* writer, int cpu) {
+	int track = cpu < 0 ? 1 : cpu + 1;
+	while (writer->num_tracks < track) {
+		writer->num_tracks++;
+		char* position = reserve_output(writer);
+		char* event_start = position;
+		position = format_text(position, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+		position = format_int(position, writer->num_tracks);
+		position = format_text(position, ",\"args\":{\"name\":\"CPU");
+		if (cpu >= 0) {
+			*position++ = ' ';
+			position = format_int(position, writer->num_tracks - 1);
+		}
+		position = format_text(position, "\"}}");
+		writer->used += position - event_start;
+	}
+	return track;
+}
+
+/*
+ * Start an event of a timeline that lasts from a time to another on the track of a CPU, up to and including
+ * its duration. The event starts at the free space of the buffer, and the caller finishes it and adds its
+ * length to the bytes used.
+ *
+ * writer:	a pointer to the output writer of the timeline
+ * name:	the name of the event, which is followed by the ID of the process if it is not -1
+ * id:		the ID of the process, or -1
+ * kind:	the category of the event
+ * start:	the time the event starts
+ * end:		the time the event ends
+ * cpu:		the CPU of the event, or -1 for a single-CPU simulation
+ *
+ * Returns: a pointer to the position after the duration
+ */
+static char* format_trace_interval(struct output_writer* writer, const char* name, int id, const char* kind, long start, long end, int cpu) {
+	int track = trace_track(writer, cpu);
+	char* position = reserve_output(writer);
+	position = format_text(position, ",\n{\"name\":\"");
+	position = format_text(position, name);
+	if (id != -1) {
+		position = format_int(position, id);
+	}
+	position = format_text(position, "\",\"cat\":\"");
+	position = format_text(position, kind);
+	position = format_text(position, "\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+	position = format_int(position, track);
+	position = format_text(position, ",\"ts\":");
+	position = format_int(position, start);
+	position = format_text(position, ",\"dur\":");
+	position = format_int(position, end - start);
+	return position;
+}
+
+/*
+ * Keep the result of a process that completed in the array of results of a specified output writer, growing
+ * the array if it is full.
+ *
+ * writer:		a pointer to the output writer
+ * id:			the ID of the process
+ * start:		the time the process was dispatched
+ * finish:		the time the process completed
+ * arrival:		the arrival time of the process
+ * service:		the service time of the process
+ * cpu:			the CPU the process ran on, or -1 for a single-CPU simulation
+ */
+static void keep_result(struct output_writer* writer, int id, long start, long finish, long arrival, long service, int cpu) {
+	if (writer->num_records == writer->records_capacity) {
+		long new_capacity = writer->records_capacity > 0 ? 2 * writer->records_capacity : 1024;
+		writer->records = (struct process_result*) arena_grow(writer->pool, writer->records, writer->num_records * sizeof(struct process_result), new_capacity * sizeof(struct process_result));
+		writer->records_capacity = new_capacity;
+	}
+	struct process_result* record = &writer->records[writer->num_records++];
+	record->id = id;
+	record->cpu = cpu;
+	record->arrival_time = arrival;
+	record->service_time = service;
+	record->start_time = start;
+	record->finish_time = finish;
+}
+
+/*
+ * Write the result of a process that ran until it completed, in the form
+ * "<id> runs <start>-<finish>: A=<arrival>, S=<service>, W=<waiting>, F=<finish>, T=<turnaround>" (with
+ * " on CPU <cpu>" after the finish time in a multi-CPU simulation).
+ *
+ * writer:		a pointer to the output writer
+ * id:			the ID of the process
+ * start:		the time the process was dispatched
+ * finish:		the time the process completed
+ * arrival:		the arrival time of the process
+ * service:		the service time of the process
+ * cpu:			the CPU the process ran on, or -1 for a single-CPU simulation
+ */
+void write_completion(struct output_writer* writer, int id, long start, long finish, long arrival, long service, int cpu) {
+	if (writer->trace != NULL) {
+		write_completion(writer->trace, id, start, finish, arrival, service, cpu);
+	}
+	if (writer->format == OUTPUT_NONE) {
+		return;
+	} else if (writer->format == OUTPUT_RECORDS) {
+		keep_result(writer, id, start, finish, arrival, service, cpu);
+		return;
+	} else if (writer->format == OUTPUT_BINARY) {
+		struct event_record record = { EVENT_COMPLETION, id, start, finish, arrival, service, cpu, 0 };
+		append_event(writer, &record);
+		return;
+	} else if (writer->format == OUTPUT_TRACE) {
+		char* position = format_trace_interval(writer, "P", id, "complete", start, finish, cpu);
+		char* event_start = writer->buffer + writer->used;
+		position = format_text(position, ",\"args\":{\"arrival\":");
+		position = format_int(position, arrival);
+		position = format_text(position, ",\"service\":");
+		position = format_int(position, service);
+		position = format_text(position, "}}");
+		writer->used += position - event_start;
+		return;
+	}
+
+	long turnaround = finish - arrival;
+	char* position = reserve_output(writer);
+	char* line_start = position;
+	position = format_run(position, id, start, finish, cpu);
+	position = format_text(position, ": A=");
+	position = format_int(position, arrival);
+	position = format_text(position, ", S=");
+	position = format_int(position, service);
+	position = format_text(position, ", W=");
+	position = format_int(position, turnaround - service);
+	position = format_text(position, ", F=");
+	position = format_int(position, finish);
+	position = format_text(position, ", T=");
+	position = format_int(position, turnaround);
+	*position++ = '\n';
+	writer->used += position - line_start;
+}
+
+/*
+ * Write the result of a process that ran until it was preempted, in the form "<id> runs <start>-<end>" (with
+ * " on CPU <cpu>" at the end in a multi-CPU simulation).
+ *
+ * writer:	a pointer to the output writer
+ * id:		the ID of the process
+ * start:	the time the process was dispatched
+ * end:		the time the process was preempted
+ * cpu:		the CPU the process ran on, or -1 for a single-CPU simulation
+ */
+void write_preemption(struct output_writer* writer, int id, long start, long end, int cpu) {
+	if (writer->trace != NULL) {
+		write_preemption(writer->trace, id, start, end, cpu);
+	}
+	if (writer->format == OUTPUT_NONE || writer->format == OUTPUT_RECORDS) {
+		return;
+	} else if (writer->format == OUTPUT_BINARY) {
+		struct event_record record = { EVENT_PREEMPTION, id, start, end, 0, 0, cpu, 0 };
+		append_event(writer, &record);
+		return;
+	} else if (writer->format == OUTPUT_TRACE) {
+		char* position = format_trace_interval(writer, "P", id, "preempt", start, end, cpu);
+		char* event_start = writer->buffer + writer->used;
+		*position++ = '}';
+		writer->used += position - event_start;
+		return;
+	}
+
+	char* position = reserve_output(writer);
+	char* line_start = position;
+	position = format_run(position, id, start, end, cpu);
+	*position++ = '\n';
+	writer->used += position - line_start;
+}
+
+/*
+ * Write that a process arrived at a specified time, as an instant event on the track of arrivals. Only a
+ * timeline records arrivals; other formats ignore them.
+ *
+ * writer:	a pointer to the output writer
+ * id:		the ID of the process
+ * time:	the arrival time of the process
+ */
+void write_arrival(struct output_writer* writer, int id, long time) {
+	if (writer->trace != NULL) {
+		write_arrival(writer->trace, id, time);
+	}
+	if (writer->format != OUTPUT_TRACE) {
+		return;
+	}
+	char* position = reserve_output(writer);
+	char* event_start = position;
+	position = format_text(position, ",\n{\"name\":\"P");
+	position = format_int(position, id);
+	position = format_text(position, " arrives\",\"cat\":\"arrive\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":0,\"ts\":");
+	position = format_int(position, time);
+	*position++ = '}';
+	writer->used += position - event_start;
+}
+
+/*
+ * Write that a CPU was idle from a specified time to another. Only a timeline records idle intervals; other
+ * formats ignore them.
+ *
+ * writer:	a pointer to the output writer
+ * start:	the time the CPU became idle
+ * end:		the time the CPU dispatched a process again
+ * cpu:		the CPU, or -1 for a single-CPU simulation
+ */
+void write_idle(struct output_writer* writer, long start, long end, int cpu) {
+	if (writer->trace != NULL) {
+		write_idle(writer->trace, start, end, cpu);
+	}
+	if (writer->format != OUTPUT_TRACE) {
+		return;
+	}
+	char* position = format_trace_interval(writer, "idle", -1, "idle", start, end, cpu);
+	char* event_start = writer->buffer + writer->used;
+	*position++ = '}';
+	writer->used += position - event_start;
+}
+
+/*
+ * Write out everything in the buffer of a specified output writer and wait until it is in the file, so that
+ * the size of the output writer is the size of the file.
+ *
+ * writer:	a pointer to the output writer
+ *
+ * Returns: 0 on success, -1 if some part of the output could not be written
+ */
+int sync_output_writer(struct output_writer* writer) {
+	if (writer->fd < 0) {
+		return 0;
+	}
+	flush_output(writer);
+	if (writer->threaded) {
+		pthread_mutex_lock(&writer->lock);
+		while (writer->pending_size != 0) {
+			pthread_cond_wait(&writer->changed, &writer->lock);
+		}
+		pthread_mutex_unlock(&writer->lock);
+	}
+	return writer->error ? -1 : 0;
+}
+
+/*
+ * Write out everything left in a specified output writer, stop its writer thread if it has one, and close
+ * the file. Its memory is released together with the memory pool that owns it.
+ *
+ * writer:	a pointer to the output writer
+ *
+ * Returns: 0 on success, -1 if some part of the output could not be written
+ */
+int close_output_writer(struct output_writer* writer) {
+	if (writer->fd < 0) {
+		return 0;
+	}
+	if (writer->format == OUTPUT_TRACE) {
+		char* position = reserve_output(writer);
+		memcpy(position, TRACE_FOOTER, sizeof(TRACE_FOOTER) - 1);
+		writer->used += sizeof(TRACE_FOOTER) - 1;
+	}
+	flush_output(writer);
+	if (writer->threaded) {
+		pthread_mutex_lock(&writer->lock);
+		writer->stopping = 1;
+		pthread_cond_signal(&writer->changed);
+		pthread_mutex_unlock(&writer->lock);
+		pthread_join(writer->thread, NULL);
+		pthread_mutex_destroy(&writer->lock);
+		pthread_cond_destroy(&writer->changed);
+	}
+	if (close(writer->fd) != 0) {
+		writer->error = 1;
+	}
+	return writer->error ? -1 : 0;
+}
+
+/*
+ * Convert a binary event log to the text format of the output file.
+ *
+ * log_path:	the path of the binary event log
+ * output_path:	the path of the text file to write
+ *
+ * Returns: 0 on success, -1 if the log cannot be read or is not a valid event log, or if the text file cannot
+ *			be written (an error statement is printed out in that case)
+ */
+int convert_event_log(const char* log_path, const char* output_path) {
+	FILE* log_file = fopen(log_path, "rb");
+	if (log_file == NULL) {
+		printf("ERROR: Cannot open file \"%s\"!\n", log_path);
+		return -1;
+	}
+
+	/* Check the magic bytes and the format version. */
+	char magic[sizeof(EVENT_LOG_MAGIC)];
+	int version;
+	if (fread(magic, 1, sizeof(magic), log_file) != sizeof(magic) || memcmp(magic, EVENT_LOG_MAGIC, sizeof(magic)) != 0
+			|| fread(&version, sizeof(int), 1, log_file) != 1 || version != EVENT_LOG_VERSION) {
+		printf("ERROR: \"%s\" is not a binary event log!\n", log_path);
+		fclose(log_file);
+		return -1;
+	}
+
+	struct arena* pool = create_arena();
+	struct output_writer* writer = open_output_writer(output_path, OUTPUT_TEXT, 0, pool);
+	int result = 0;
+	if (writer == NULL) {
+		printf("ERROR: Cannot open/create file \"%s\"\n", output_path);
+		result = -1;
+	} else {
+		/* Read the records in batches and write each of them in the text format. The log is damaged if it
+		 * ends in the middle of a record or holds a record of an unknown kind. */
+		struct event_record batch[4096];
+		size_t num_bytes;
+		while (result == 0 && (num_bytes = fread(batch, 1, sizeof(batch), log_file)) > 0) {
+			size_t num_read = num_bytes / sizeof(struct event_record);
+			for (size_t i = 0; i < num_read && result == 0; i++) {
+				const struct event_record record = batch[i];
+				if (record.type == EVENT_COMPLETION) {
+					write_completion(writer, record.id, record.start, record.end, record.arrival, record.service, record.cpu);
+				} else if (record.type == EVENT_PREEMPTION) {
+					write_preemption(writer, record.id, record.start, record.end, record.cpu);
+				} else {
+					result = -1;
+				}
+			}
+			if (num_bytes % sizeof(struct event_record) != 0) {
+				result = -1;
+			}
+		}
+		if (ferror(log_file)) {
+			printf("ERROR: Cannot read file \"%s\"!\n", log_path);
+			result = -1;
+		} else if (result != 0) {
+			printf("ERROR: \"%s\" is a damaged event log!\n", log_path);
+		}
+		if (close_output_writer(writer) != 0) {
+			printf("ERROR: Cannot write file \"%s\"\n", output_path);
+			result = -1;
+		}
+	}
+	destroy_arena(pool);
+	fclose(log_file);
+	return result;
+}
@@ -0,0 +1,126 @@
+/**
+ * Implementation of running several scheduling policies at once over the same input. The input is read once
+ * into a process table that all runs share without changing it, and each policy is simulated on a thread of
+ * its own with private remaining times, memory pool and output file.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include "mydispatcher.h"
+
+/*
+ * Create a private copy of a process table for one simulation. The ID, arrival time and service time columns
+ * are shared with the original table, which must not change while the copy is used; only the remaining time
+ * column, which a simulation updates, is copied.
+ *
+ * shared_table:	a pointer to the table to copy
+ * pool:			a pointer to the memory pool that owns the copy
+ *
+ * Returns: a pointer to the copy
+ */
+struct process_table* copy_process_table(const struct process_table* shared_table, struct arena* pool) {
+	struct process_table* private_table = (struct process_table*) arena_alloc(pool, sizeof(struct process_table));
+	*private_table = *shared_table;
+	private_table->remaining_time = (long*) arena_alloc(pool, shared_table->size * sizeof(long));
+	memcpy(private_table->remaining_time, shared_table->service_time, shared_table->size * sizeof(long));
+	private_table->pool = pool;
+	return private_table;
+}
+
+/*
+ * The function run by the thread of one simulation.
+ *
+ * argument:	a pointer to the policy_run describing the simulation
+ *
+ * Returns: NULL
+ */
+static void* policy_run_main(void* argument) {
+	struct policy_run* run = (struct policy_run*) argument;
+
+	/* Everything this thread allocates comes from its own memory pool, so no locking is needed. */
+	struct arena* pool = create_arena();
+	struct output_writer* output = open_output_writer(run->output_path, run->output_format, run->writer_thread, pool);
+	if (output == NULL) {
+		run->error = 1;
+	} else {
+		struct arrival_stream arrivals;
+		init_table_stream(&arrivals, copy_process_table(run->table, pool));
+		run->results.latency = run->percentiles != -1 ? create_latency_stats(run->percentiles, pool) : NULL;
+		run->results.checkpoint = NULL;
+		run->results.what_if = NULL;
+		simulate(run->policy, run->params, &arrivals, output, pool, &run->results);
+		if (run->results.latency != NULL) {
+			/* The distributions live in this thread's memory pool, so only their summary is kept. */
+			summarize_latency(run->results.latency, &run->latency);
+			run->results.latency = NULL;
+		}
+		run->error = close_output_writer(output) != 0;
+	}
+	destroy_arena(pool);
+	return NULL;
+}
+
+/*
+ * Simulate several scheduling policies over the same table of processes, each on a thread of its own. The
+ * results of the policy named NAME are written to "output_NAME.dat" (or "output_NAME.bin" for a binary
+ * event log).
+ *
+ * runs:		an array describing the simulations, whose policy, params, table, output_format,
+ *				writer_thread and percentiles fields must be set; the other fields are filled in
+ * num_runs:	the number of simulations
+ *
+ * Returns: 0 on success, -1 if the output of some simulation could not be written (an error statement is
+ *			printed out in that case)
+ */
+int run_policies_in_parallel(struct policy_run* runs, int num_runs) {
+	for (int i = 0; i < num_runs; i++) {
+		snprintf(runs[i].output_path, sizeof(runs[i].output_path), "output_%s.%s", runs[i].policy->name, runs[i].output_format == OUTPUT_BINARY ? "bin" : "dat");
+		runs[i].error = 0;
+		runs[i].started = pthread_create(&runs[i].thread, NULL, policy_run_main, &runs[i]) == 0;
+		if (!runs[i].started) {
+			/* If no thread can be started, run the simulation on this thread instead. */
+			policy_run_main(&runs[i]);
+		}
+	}
+
+	int result = 0;
+	for (int i = 0; i < num_runs; i++) {
+		if (runs[i].started) {
+			pthread_join(runs[i].thread, NULL);
+		}
+		if (runs[i].error) {
+			printf("ERROR: Cannot write file \"%s\"\n", runs[i].output_path);
+			result = -1;
+		}
+	}
+	return result;
+}
+
+/*
+ * Print out a table comparing the average turnaround time, average normalized turnaround time and average
+ * waiting time of several simulations, one line per policy, followed by the percentiles of every policy if
+ * they were worked out.
+ *
+ * runs:		an array of finished simulations
+ * num_runs:	the number of simulations
+ */
+void print_comparison(const struct policy_run* runs, int num_runs) {
+	printf("%-8s %24s %36s %21s\n", "Policy", "Average turnaround time", "Average normalized turnaround time", "Average waiting time");
+	for (int i = 0; i < num_runs; i++) {
+		const struct sim_results* results = &runs[i].results;
+		if (results->num_processes > 0) {
+			printf("%-8s %24f %36f %21f\n", runs[i].policy->name, sum_value(&results->sum_turnaround)/results->num_processes, sum_value(&results->sum_normalized_turnaround)/results->num_processes, sum_value(&results->sum_waiting)/results->num_processes);
+		}
+	}
+	for (int i = 0; i < num_runs; i++) {
+		if (runs[i].percentiles != -1 && runs[i].latency.count > 0) {
+			printf("\n%s:\n", runs[i].policy->name);
+			print_latency_summary(&runs[i].latency);
+		}
+	}
+}
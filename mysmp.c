@@ -0,0 +1,555 @@
+/**
+ * Implementation of the simulation loop for several CPUs. Every CPU runs one process at a time and dispatches
+ * from a Ready state of the scheduling policy, which is either shared by all CPUs or private to each CPU.
+ * With private Ready states, arrivals are either spread over the CPUs by load, or idle CPUs steal processes
+ * from the others. The next event of every CPU (a completion or the end of a time slice) is kept in a
+ * priority queue, so that each step of the clock only touches the CPUs that have something to do, and with a
+ * shared Ready state the running CPUs are kept in a priority queue by the key the policy preempts by, so that an
+ * arrival only looks at the CPUs it preempts and at most one more.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include "mydispatcher.h"
+
+/* Representation of one CPU of a multi-CPU simulation. */
+struct cpu {
+	void* ready;				// the Ready state the CPU dispatches from (shared by all CPUs in QUEUE_GLOBAL)
+	int running;				// the index of the running process, or -1 if the CPU is idle
+	long start_time;			// the time the running process was dispatched
+	long slice_end;				// the time the time slice of the running process ends, or -1 if unlimited
+	long synced_time;			// the time the remaining time of the running process was last brought up to date
+	long event_time;			// the time of the next event of the CPU, if it is running a process
+	int touched;				// whether the CPU is in the list of CPUs that got new ready processes
+	int in_idle_heap;			// whether the CPU has an entry in the priority queue of idle CPUs
+	long idle_since;			// the time the CPU last became idle
+	long preempt_key;			// the running key of the running process, negated (only with running_cpus)
+};
+
+/* Representation of the state of a multi-CPU simulation, shared by the steps of the loop. */
+struct smp_state {
+	const struct policy* policy;		// the scheduling policy
+	int queue_mode;						// how the CPUs share the processes
+	int num_cpus;						// the number of CPUs
+	struct cpu* cpus;					// an array of the CPUs
+	struct process_table* table;		// the table the processes are in
+	struct arrival_stream* arrivals;	// the stream of arriving processes
+	struct output_writer* output;		// the output writer to write results to
+	struct sim_results* results;		// the totals needed for the averages
+	struct smp_results* smp_results;	// the statistics of every CPU
+	struct heap* events;				// the CPUs that run a process, by the time of their next event
+	struct heap* idle_cpus;				// the idle CPUs by number, at most once each (an entry is stale if the
+										// CPU has since dispatched from its own Ready state)
+	struct heap* running_cpus;			// with a shared Ready state and a policy that arrivals can preempt, the
+										// running CPUs by preempt_key, so the one to preempt first is on top (an
+										// entry is stale if the CPU has since stopped), or NULL otherwise
+	int* touched_cpus;					// the CPUs that got new ready processes in the current step
+	int num_touched;					// the number of such CPUs
+	int num_ready;						// the number of processes in all Ready states together
+	int* last_cpu;						// the CPU each row of the table last ran on, or -1
+	int last_cpu_capacity;				// the number of rows last_cpu can hold
+};
+
+/*
+ * Remember that a CPU got new ready processes, so that it is considered in the next dispatch step.
+ *
+ * state:	a pointer to the state of the simulation
+ * cpu:		the number of the CPU
+ */
+static void touch_cpu(struct smp_state* state, int cpu) {
+	if (!state->cpus[cpu].touched) {
+		state->cpus[cpu].touched = 1;
+		state->touched_cpus[state->num_touched++] = cpu;
+	}
+}
+
+/*
+ * Get the number of processes a CPU is responsible for: those in its Ready state and the one it runs.
+ *
+ * state:	a pointer to the state of the simulation
+ * cpu:		the number of the CPU
+ *
+ * Returns: the load of the CPU
+ */
+static int cpu_load(struct smp_state* state, int cpu) {
+	return state->policy->num_ready(state->cpus[cpu].ready) + (state->cpus[cpu].running != -1);
+}
+
+/*
+ * Choose the CPU an arriving process is added to. With QUEUE_BALANCED, two CPUs are picked by hashing the
+ * arrival number and the less loaded one is chosen ("power of two choices"), which balances the load almost
+ * as well as looking at every CPU at a constant cost. With QUEUE_STEALING, arrivals are spread round-robin
+ * and left for idle CPUs to steal.
+ *
+ * state:		a pointer to the state of the simulation
+ * sequence:	the number of processes that arrived before this one
+ *
+ * Returns: the number of the CPU
+ */
+static int place_arrival(struct smp_state* state, long sequence) {
+	if (state->queue_mode == QUEUE_GLOBAL) {
+		return 0;
+	} else if (state->queue_mode == QUEUE_STEALING) {
+		return (int) (sequence % state->num_cpus);
+	}
+	unsigned long hash = (unsigned long) sequence * 0x9E3779B97F4A7C15UL;
+	int first = (int) ((hash >> 16) % state->num_cpus);
+	int second = (int) ((hash >> 40) % state->num_cpus);
+	return cpu_load(state, second) < cpu_load(state, first) ? second : first;
+}
+
+/*
+ * Bring the remaining time of the process running on a CPU up to date with the current time.
+ *
+ * state:	a pointer to the state of the simulation
+ * cpu:		the number of the CPU
+ * now:		the current time
+ */
+static void sync_cpu(struct smp_state* state, int cpu, long now) {
+	struct cpu* current_cpu = &state->cpus[cpu];
+	state->table->remaining_time[current_cpu->running] -= now - current_cpu->synced_time;
+	current_cpu->synced_time = now;
+}
+
+/*
+ * Work out the time of the next event of a CPU, which is when its running process completes or its time
+ * slice ends, whichever is earlier, and add it to the priority queue of events.
+ *
+ * state:	a pointer to the state of the simulation
+ * cpu:		the number of the CPU
+ */
+static void schedule_event(struct smp_state* state, int cpu) {
+	struct cpu* current_cpu = &state->cpus[cpu];
+	current_cpu->event_time = current_cpu->synced_time + state->table->remaining_time[current_cpu->running];
+	if (current_cpu->slice_end != -1 && current_cpu->slice_end < current_cpu->event_time) {
+		current_cpu->event_time = current_cpu->slice_end;
+	}
+	heap_insert(state->events, cpu, current_cpu->event_time);
+}
+
+/*
+ * Drop the stale entries of the priority queue of running CPUs by building it again from the CPUs, so that it
+ * never holds more than a few entries per CPU however long the simulation runs.
+ *
+ * state:	a pointer to the state of the simulation
+ */
+static void rebuild_running_cpus(struct smp_state* state) {
+	state->running_cpus->size = 0;
+	state->running_cpus->num_unsorted = 0;
+	for (int i = 0; i < state->num_cpus; i++) {
+		if (state->cpus[i].running != -1) {
+			heap_append(state->running_cpus, i, state->cpus[i].preempt_key);
+		}
+	}
+}
+
+/*
+ * Dispatch the process chosen by the policy from the Ready state of a CPU on that CPU.
+ *
+ * state:	a pointer to the state of the simulation
+ * cpu:		the number of the CPU, which must be idle
+ * now:		the current time
+ */
+static void dispatch(struct smp_state* state, int cpu, long now) {
+	struct cpu* current_cpu = &state->cpus[cpu];
+	int process = state->policy->select_next(current_cpu->ready, state->table, now);
+	state->num_ready--;
+	METRIC_ADD(context_switches, 1);
+	if (state->results->latency != NULL) {
+		latency_dispatch(state->results->latency, state->table, process, now);
+	}
+	if (state->last_cpu[process] != -1 && state->last_cpu[process] != cpu) {
+		state->smp_results->cpus[cpu].migrations++;
+	}
+	state->last_cpu[process] = cpu;
+	if (now > current_cpu->idle_since) {
+		write_idle(state->output, current_cpu->idle_since, now, cpu);
+	}
+
+	current_cpu->running = process;
+	current_cpu->start_time = now;
+	current_cpu->synced_time = now;
+	current_cpu->slice_end = slice_end_time(now, state->policy->time_slice(current_cpu->ready, state->table, process));
+	schedule_event(state, cpu);
+	if (state->running_cpus != NULL) {
+		current_cpu->preempt_key = -state->policy->running_key(current_cpu->ready, state->table, process, now);
+		heap_insert(state->running_cpus, cpu, current_cpu->preempt_key);
+		if (state->running_cpus->size > 2 * state->num_cpus) {
+			rebuild_running_cpus(state);
+		}
+	}
+}
+
+/*
+ * Take the running process off a CPU, which becomes idle.
+ *
+ * state:	a pointer to the state of the simulation
+ * cpu:		the number of the CPU
+ * now:		the current time
+ */
+static void stop_cpu(struct smp_state* state, int cpu, long now) {
+	struct cpu* current_cpu = &state->cpus[cpu];
+	state->smp_results->cpus[cpu].busy_time += now - current_cpu->start_time;
+	current_cpu->running = -1;
+	current_cpu->idle_since = now;
+	if (!current_cpu->in_idle_heap) {
+		current_cpu->in_idle_heap = 1;
+		heap_insert(state->idle_cpus, cpu, cpu);
+	}
+	touch_cpu(state, cpu);
+}
+
+/*
+ * Give the process running on a CPU back to the policy, writing the needed information to the output.
+ *
+ * state:			a pointer to the state of the simulation
+ * cpu:				the number of the CPU
+ * slice_expired:	whether the time slice of the process has ended
+ * now:				the current time
+ */
+static void preempt_cpu(struct smp_state* state, int cpu, int slice_expired, long now) {
+	struct cpu* current_cpu = &state->cpus[cpu];
+	int process = current_cpu->running;
+	write_preemption(state->output, state->table->id[process], current_cpu->start_time, now, cpu);
+	state->results->num_events++;
+	state->policy->preempt(current_cpu->ready, state->table, process, slice_expired, now);
+	state->num_ready++;
+	METRIC_ADD(preemptions, 1);
+	METRIC_ADD(ready_inserts, 1);
+	if (state->results->latency != NULL) {
+		latency_ready(state->results->latency, state->table, process, now);
+	}
+	stop_cpu(state, cpu, now);
+}
+
+/*
+ * Handle the event of a CPU that is due at the current time: its running process completes, is preempted at
+ * the end of its time slice, or gets a new time slice.
+ *
+ * state:	a pointer to the state of the simulation
+ * cpu:		the number of the CPU
+ * now:		the current time
+ */
+static void handle_event(struct smp_state* state, int cpu, long now) {
+	struct cpu* current_cpu = &state->cpus[cpu];
+	struct process_table* table = state->table;
+	int process = current_cpu->running;
+	sync_cpu(state, cpu, now);
+	int slice_expired = current_cpu->slice_end != -1 && now >= current_cpu->slice_end;
+
+	if (table->remaining_time[process] == 0) {
+		/* The running process completes: write the needed information to the output and add its turnaround
+		 * time, normalized turnaround time and waiting time to the totals. */
+		long turnaround_time = now - table->arrival_time[process];
+		write_completion(state->output, table->id[process], current_cpu->start_time, now, table->arrival_time[process], table->service_time[process], cpu);
+		state->results->num_processes++;
+		add_to_sum(&state->results->sum_turnaround, turnaround_time);
+		add_to_sum(&state->results->sum_normalized_turnaround, ((double) turnaround_time) / table->service_time[process]);
+		add_to_sum(&state->results->sum_waiting, turnaround_time - table->service_time[process]);
+		state->results->num_events++;
+		if (state->results->latency != NULL) {
+			latency_complete(state->results->latency, turnaround_time - table->service_time[process], turnaround_time);
+		}
+		finish_arrival(state->arrivals, process);
+		stop_cpu(state, cpu, now);
+
+	} else if (state->policy->should_preempt(current_cpu->ready, table, process, slice_expired, now)) {
+		preempt_cpu(state, cpu, slice_expired, now);
+
+	} else {
+		/* The time slice has ended but the policy keeps the running process, so give it a new one. */
+		if (slice_expired) {
+			current_cpu->slice_end = slice_end_time(now, state->policy->time_slice(current_cpu->ready, table, process));
+		}
+		schedule_event(state, cpu);
+	}
+}
+
+/*
+ * Take the lowest-numbered idle CPU out of the priority queue of idle CPUs, skipping stale entries.
+ *
+ * state:	a pointer to the state of the simulation
+ *
+ * Returns: the number of the CPU, or -1 if every CPU is running a process
+ */
+static int take_idle_cpu(struct smp_state* state) {
+	while (state->idle_cpus->size > 0) {
+		int cpu = heap_extract_min(state->idle_cpus);
+		state->cpus[cpu].in_idle_heap = 0;
+		if (state->cpus[cpu].running == -1) {
+			return cpu;
+		}
+	}
+	return -1;
+}
+
+/*
+ * Move a process from the Ready state of some other CPU to the Ready state of an idle CPU. The victim is the
+ * first CPU after the thief that has a ready process, and it gives up the process its policy would run next.
+ * The stolen process joins the Ready state of the thief as if it had just arrived.
+ *
+ * state:	a pointer to the state of the simulation
+ * thief:	the number of the idle CPU
+ * now:		the current time
+ *
+ * Returns: 1 if a process was stolen, 0 if no other CPU has a ready process
+ */
+static int steal(struct smp_state* state, int thief, long now) {
+	for (int i = 1; i < state->num_cpus; i++) {
+		int victim = (thief + i) % state->num_cpus;
+		if (state->policy->num_ready(state->cpus[victim].ready) > 0) {
+			int process = state->policy->select_next(state->cpus[victim].ready, state->table, now);
+			state->policy->add_ready(state->cpus[thief].ready, state->table, process, now);
+			METRIC_ADD(ready_inserts, 1);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Dispatch a process on every idle CPU that can get one at the current time.
+ *
+ * state:	a pointer to the state of the simulation
+ * now:		the current time
+ */
+static void dispatch_idle_cpus(struct smp_state* state, long now) {
+	if (state->queue_mode == QUEUE_GLOBAL) {
+		/* Every idle CPU takes from the shared Ready state, lowest-numbered first. */
+		while (state->num_ready > 0) {
+			int cpu = take_idle_cpu(state);
+			if (cpu == -1) {
+				break;
+			}
+			dispatch(state, cpu, now);
+		}
+		return;
+	}
+
+	/* An idle CPU dispatches from its own Ready state if it can. */
+	for (int i = 0; i < state->num_touched; i++) {
+		int cpu = state->touched_cpus[i];
+		if (state->cpus[cpu].running == -1 && state->policy->num_ready(state->cpus[cpu].ready) > 0) {
+			dispatch(state, cpu, now);
+		}
+	}
+
+	/* With work stealing, the CPUs that are still idle steal whatever is left in the others. */
+	while (state->queue_mode == QUEUE_STEALING && state->num_ready > 0) {
+		int cpu = take_idle_cpu(state);
+		if (cpu == -1) {
+			break;
+		}
+		if (!steal(state, cpu, now)) {
+			state->cpus[cpu].in_idle_heap = 1;
+			heap_insert(state->idle_cpus, cpu, cpu);
+			break;
+		}
+		dispatch(state, cpu, now);
+	}
+}
+
+/*
+ * Let the policy preempt running processes in favor of processes that arrived at the current time. With a
+ * shared Ready state, the running CPUs are taken from the top of running_cpus, the process the policy would
+ * preempt first each time, until one is not preempted; otherwise only the CPUs that got new ready processes
+ * are considered.
+ *
+ * state:	a pointer to the state of the simulation
+ * now:		the current time
+ */
+static void check_preemptions(struct smp_state* state, long now) {
+	if (state->running_cpus != NULL) {
+		while (state->num_ready > 0 && state->running_cpus->size > 0) {
+			int cpu = heap_peek(state->running_cpus);
+			struct cpu* current_cpu = &state->cpus[cpu];
+			if (current_cpu->running == -1 || current_cpu->preempt_key != heap_peek_key(state->running_cpus)) {
+				heap_extract_min(state->running_cpus);
+				continue;
+			}
+			/* A process dispatched at this time was chosen with the arrivals already in view, and if the process
+			 * the policy would preempt first stays, so do all the others. */
+			if (current_cpu->start_time == now) {
+				break;
+			}
+			sync_cpu(state, cpu, now);
+			if (!state->policy->should_preempt(current_cpu->ready, state->table, current_cpu->running, 0, now)) {
+				break;
+			}
+			heap_extract_min(state->running_cpus);
+			preempt_cpu(state, cpu, 0, now);
+			dispatch(state, cpu, now);
+		}
+		return;
+	}
+	for (int i = 0; i < state->num_touched && state->num_ready > 0; i++) {
+		int cpu = state->touched_cpus[i];
+		struct cpu* current_cpu = &state->cpus[cpu];
+		if (current_cpu->running == -1 || current_cpu->start_time == now) {
+			/* A process dispatched at this time was chosen with the arrivals already in view. */
+			continue;
+		}
+		sync_cpu(state, cpu, now);
+		if (state->policy->should_preempt(current_cpu->ready, state->table, current_cpu->running, 0, now)) {
+			preempt_cpu(state, cpu, 0, now);
+			dispatch(state, cpu, now);
+		}
+	}
+}
+
+/*
+ * Produce the results of a specified scheduling policy for a specified stream of processes on several CPUs.
+ * The steps at each time are the same as in simulate(): first every process arriving at that time is added,
+ * then every CPU whose running process completes or whose time slice ends is handled, then idle CPUs
+ * dispatch, and finally the policy may preempt running processes in favor of the arrivals. With one CPU, the
+ * results are the same as those of simulate().
+ *
+ * policy:		a pointer to the scheduling policy
+ * params:		a pointer to the parameters of the policy
+ * num_cpus:	the number of CPUs
+ * queue_mode:	QUEUE_GLOBAL, QUEUE_BALANCED or QUEUE_STEALING
+ * arrivals:	a pointer to the stream of arriving processes
+ * output:		a pointer to the output writer to write results to
+ * pool:		a pointer to the memory pool used for the state of the simulation
+ * results:		a pointer to where the totals needed for the averages are stored
+ * smp_results:	a pointer to where the statistics of every CPU are stored
+ */
+void simulate_smp(const struct policy* policy, const struct policy_params* params, int num_cpus, int queue_mode, struct arrival_stream* arrivals, struct output_writer* output, struct arena* pool, struct sim_results* results, struct smp_results* smp_results) {
+	results->num_processes = 0;
+	memset(&results->sum_turnaround, 0, sizeof(struct compensated_sum));
+	memset(&results->sum_normalized_turnaround, 0, sizeof(struct compensated_sum));
+	memset(&results->sum_waiting, 0, sizeof(struct compensated_sum));
+	results->num_events = 0;
+	smp_results->num_cpus = num_cpus;
+	smp_results->cpus = (struct cpu_stats*) arena_alloc(pool, num_cpus * sizeof(struct cpu_stats));
+	memset(smp_results->cpus, 0, num_cpus * sizeof(struct cpu_stats));
+	smp_results->start_time = 0;
+	smp_results->end_time = 0;
+
+	/* Continue only if the stream of processes is not empty. */
+	if (!has_arrival(arrivals)) {
+		return;
+	}
+
+	struct smp_state state;
+	state.policy = policy;
+	state.queue_mode = queue_mode;
+	state.num_cpus = num_cpus;
+	state.table = arrivals->table;
+	state.arrivals = arrivals;
+	state.output = output;
+	state.results = results;
+	state.smp_results = smp_results;
+	state.events = create_heap(pool);
+	state.idle_cpus = create_heap(pool);
+	state.running_cpus = queue_mode == QUEUE_GLOBAL && policy->running_key != NULL ? create_heap(pool) : NULL;
+	state.touched_cpus = (int*) arena_alloc(pool, num_cpus * sizeof(int));
+	state.num_touched = 0;
+	state.num_ready = 0;
+	state.last_cpu_capacity = state.table->capacity;
+	state.last_cpu = (int*) arena_alloc(pool, state.last_cpu_capacity * sizeof(int));
+
+	/* Create the CPUs, all idle, with one shared Ready state or one each. */
+	state.cpus = (struct cpu*) arena_alloc(pool, num_cpus * sizeof(struct cpu));
+	void* shared_ready = queue_mode == QUEUE_GLOBAL ? policy->create(params, pool) : NULL;
+	for (int i = 0; i < num_cpus; i++) {
+		state.cpus[i].ready = shared_ready != NULL ? shared_ready : policy->create(params, pool);
+		state.cpus[i].running = -1;
+		state.cpus[i].touched = 0;
+		state.cpus[i].in_idle_heap = 1;
+		state.cpus[i].idle_since = next_arrival_time(arrivals);
+		heap_insert(state.idle_cpus, i, i);
+	}
+
+	long current_time = next_arrival_time(arrivals);
+	smp_results->start_time = current_time;
+	long num_arrived = 0;
+	while (1) {
+		/* First, hand all processes that arrive at the current time to the policy. */
+		int any_arrival = 0;
+		while (has_arrival(arrivals) && next_arrival_time(arrivals) <= current_time) {
+			int arrived_process = take_arrival(arrivals);
+			write_arrival(output, state.table->id[arrived_process], current_time);
+			if (state.last_cpu_capacity < state.table->capacity) {
+				/* If the process table has grown, grow the array of last CPUs with it. */
+				state.last_cpu = (int*) arena_grow(pool, state.last_cpu, state.last_cpu_capacity * sizeof(int), state.table->capacity * sizeof(int));
+				state.last_cpu_capacity = state.table->capacity;
+			}
+			state.last_cpu[arrived_process] = -1;
+			int cpu = place_arrival(&state, num_arrived++);
+			policy->add_ready(state.cpus[cpu].ready, state.table, arrived_process, current_time);
+			state.num_ready++;
+			METRIC_ADD(ready_inserts, 1);
+			if (results->latency != NULL) {
+				latency_ready(results->latency, state.table, arrived_process, current_time);
+			}
+			touch_cpu(&state, cpu);
+			any_arrival = 1;
+		}
+
+		/* Then, handle every CPU whose event is due. An entry whose CPU has since stopped, or has a later
+		 * event, is stale and skipped. */
+		while (state.events->size > 0 && heap_peek_key(state.events) <= current_time) {
+			int cpu = heap_extract_min(state.events);
+			if (state.cpus[cpu].running != -1 && state.cpus[cpu].event_time == current_time) {
+				handle_event(&state, cpu, current_time);
+			}
+		}
+
+		/* Dispatch on the idle CPUs, then let arrivals preempt running processes if the policy allows it. */
+		dispatch_idle_cpus(&state, current_time);
+		if (any_arrival && policy->preempt_on_arrival) {
+			check_preemptions(&state, current_time);
+		}
+		for (int i = 0; i < state.num_touched; i++) {
+			state.cpus[state.touched_cpus[i]].touched = 0;
+		}
+		state.num_touched = 0;
+
+		/* Skip to the next time something can happen: a process arrives or some CPU has an event. */
+		if (state.events->size > 0) {
+			long next_time = heap_peek_key(state.events);
+			if (has_arrival(arrivals) && next_arrival_time(arrivals) < next_time) {
+				next_time = next_arrival_time(arrivals);
+			}
+			METRIC_READY_DEPTH(state.num_ready, next_time - current_time);
+			current_time = next_time;
+		} else if (has_arrival(arrivals)) {
+			METRIC_READY_DEPTH(state.num_ready, next_arrival_time(arrivals) - current_time);
+			current_time = next_arrival_time(arrivals);
+		} else {
+			/* If nothing is running and nothing is left to arrive, all processes have been scheduled. */
+			break;
+		}
+	}
+	smp_results->end_time = current_time;
+
+	/* Every CPU is idle from the time it last stopped until the end of the simulation. */
+	for (int i = 0; i < num_cpus; i++) {
+		if (state.cpus[i].idle_since < current_time) {
+			write_idle(output, state.cpus[i].idle_since, current_time, i);
+		}
+	}
+}
+
+/*
+ * Print out the utilization (the fraction of the time from the first arrival to the last completion the CPU
+ * ran some process) and the number of migrations of every CPU of a multi-CPU simulation.
+ *
+ * smp_results:	a pointer to the statistics of every CPU
+ */
+void print_cpu_stats(const struct smp_results* smp_results) {
+	long total_migrations = 0;
+	long elapsed = smp_results->end_time - smp_results->start_time;
+	for (int i = 0; i < smp_results->num_cpus; i++) {
+		double utilization = elapsed > 0 ? (double) smp_results->cpus[i].busy_time / elapsed : 0;
+		printf("CPU %d: utilization = %f, migrations = %ld\n", i, utilization, smp_results->cpus[i].migrations);
+		total_migrations += smp_results->cpus[i].migrations;
+	}
+	printf("Total migrations = %ld\n", total_migrations);
+}
@@ -0,0 +1,253 @@
+/**
+ * Implementation of parameter sweeps, which simulate a scheduling policy for every combination of values of
+ * its parameters (such as every RR time quantum from 1 to 20) over the same input. The input is read once and
+ * shared by all configurations, which are simulated on a work-stealing thread pool, and the averages of every
+ * configuration are written as CSV.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <limits.h>
+#include <string.h>
+#include "mydispatcher.h"
+
+/* The largest number of values a single parameter can take in a grid. */
+#define MAX_SWEEP_VALUES 4096
+
+/* The largest number of configurations a sweep can have. */
+#define MAX_SWEEP_POINTS 1000000
+
+/*
+ * Read a non-negative integer at a specified position of a grid.
+ *
+ * cursor:	a pointer to the position to read from, which is moved past the integer
+ * value:	a pointer to where the integer is stored
+ *
+ * Returns: 1 if an integer that fits in a long was read, 0 otherwise
+ */
+static int scan_grid_integer(const char** cursor, long* value) {
+	const char* current = *cursor;
+	long result = 0;
+	if (*current < '0' || *current > '9') {
+		return 0;
+	}
+	while (*current >= '0' && *current <= '9') {
+		int digit = *current - '0';
+		if (result > (LONG_MAX - digit) / 10) {
+			return 0;
+		}
+		result = result * 10 + digit;
+		current++;
+	}
+	*cursor = current;
+	*value = result;
+	return 1;
+}
+
+/*
+ * Read the list of values of one parameter, which is a comma-separated list of items, each of which is a
+ * single value "A", a range "A-B" or a range with a step "A-B/S". The list ends at a colon or at the end of
+ * the grid.
+ *
+ * cursor:		a pointer to the start of the list, which is moved past it
+ * values:		an array of at least MAX_SWEEP_VALUES elements where the values are stored
+ *
+ * Returns: the number of values, or 0 if the list is not valid
+ */
+static int scan_value_list(const char** cursor, long* values) {
+	int num_values = 0;
+	while (1) {
+		long first;
+		long last;
+		long step = 1;
+		if (!scan_grid_integer(cursor, &first)) {
+			return 0;
+		}
+		last = first;
+		if (**cursor == '-') {
+			(*cursor)++;
+			if (!scan_grid_integer(cursor, &last) || last < first) {
+				return 0;
+			}
+			if (**cursor == '/') {
+				(*cursor)++;
+				if (!scan_grid_integer(cursor, &step) || step == 0) {
+					return 0;
+				}
+			}
+		}
+		for (long value = first; ; value += step) {
+			if (num_values == MAX_SWEEP_VALUES) {
+				return 0;
+			}
+			values[num_values++] = value;
+			if (last - value < step) {
+				/* Stop before the next value passes the end of the range (or the largest long). */
+				break;
+			}
+		}
+		if (**cursor != ',') {
+			return num_values;
+		}
+		(*cursor)++;
+	}
+}
+
+/*
+ * Expand a parameter grid into the configurations of a parameter sweep. A grid is the name of a policy,
+ * followed by any number of ":NAME=VALUES", where NAME is "quantum", "levels", "boost" or "aging" and VALUES is
+ * a list accepted by scan_value_list(); for example "MLFQ:levels=2-4:boost=0,50,100". Every combination of values
+ * becomes one configuration, and parameters not in the grid keep their default values.
+ *
+ * grid:		the parameter grid
+ * defaults:	a pointer to the default values of the parameters
+ * points:		a pointer to the array of configurations, which is grown with realloc() as needed
+ * num_points:	the number of configurations already in the array
+ * capacity:	a pointer to the number of configurations the array can hold
+ *
+ * Returns: the new number of configurations, or -1 if the grid is not valid
+ */
+int expand_sweep_grid(const char* grid, const struct policy_params* defaults, struct sweep_point** points, int num_points, int* capacity) {
+	/* Find the policy, whose name ends at the first colon. */
+	char name[32];
+	size_t length = strcspn(grid, ":");
+	if (length == 0 || length >= sizeof(name)) {
+		return -1;
+	}
+	memcpy(name, grid, length);
+	name[length] = '\0';
+	const struct policy* policy = find_policy(name);
+	if (policy == NULL) {
+		return -1;
+	}
+
+	/* Read the values of every parameter. A parameter not in the grid takes only its default value. */
+	static const char* const knob_names[] = { "quantum", "levels", "boost", "aging" };
+	long* knob_values[4];
+	int num_knob_values[4] = { 1, 1, 1, 1 };
+	for (int i = 0; i < 4; i++) {
+		knob_values[i] = (long*) malloc(MAX_SWEEP_VALUES * sizeof(long));
+	}
+	knob_values[0][0] = defaults->quantum;
+	knob_values[1][0] = defaults->num_levels;
+	knob_values[2][0] = defaults->boost_interval;
+	knob_values[3][0] = defaults->aging_interval;
+
+	int result = num_points;
+	const char* cursor = grid + length;
+	while (result >= 0 && *cursor == ':') {
+		cursor++;
+		int knob = -1;
+		for (int i = 0; i < 4; i++) {
+			size_t knob_length = strlen(knob_names[i]);
+			if (strncmp(cursor, knob_names[i], knob_length) == 0 && cursor[knob_length] == '=') {
+				knob = i;
+				cursor += knob_length + 1;
+			}
+		}
+		if (knob < 0 || (num_knob_values[knob] = scan_value_list(&cursor, knob_values[knob])) == 0) {
+			result = -1;
+		}
+	}
+	if (*cursor != '\0') {
+		result = -1;
+	}
+
+	/* Check the values, since the policies expect a positive time quantum and 1 to 16 levels. */
+	for (int i = 0; result >= 0 && i < num_knob_values[0]; i++) {
+		if (knob_values[0][i] == 0) {
+			result = -1;
+		}
+	}
+	for (int i = 0; result >= 0 && i < num_knob_values[1]; i++) {
+		if (knob_values[1][i] < 1 || knob_values[1][i] > 16) {
+			result = -1;
+		}
+	}
+
+	/* Add one configuration for every combination of values. */
+	long num_combinations = (long) num_knob_values[0] * num_knob_values[1] * num_knob_values[2] * num_knob_values[3];
+	if (result >= 0 && num_points + num_combinations > MAX_SWEEP_POINTS) {
+		result = -1;
+	}
+	for (long combination = 0; result >= 0 && combination < num_combinations; combination++) {
+		if (result == *capacity) {
+			*capacity = *capacity > 0 ? 2 * *capacity : 64;
+			*points = (struct sweep_point*) realloc(*points, *capacity * sizeof(struct sweep_point));
+		}
+		struct sweep_point* point = &(*points)[result++];
+		point->policy = policy;
+		point->params = *defaults;
+		point->params.quantum = knob_values[0][combination % num_knob_values[0]];
+		point->params.num_levels = (int) knob_values[1][combination / num_knob_values[0] % num_knob_values[1]];
+		point->params.boost_interval = knob_values[2][combination / num_knob_values[0] / num_knob_values[1] % num_knob_values[2]];
+		point->params.aging_interval = knob_values[3][combination / num_knob_values[0] / num_knob_values[1] / num_knob_values[2]];
+	}
+
+	for (int i = 0; i < 4; i++) {
+		free(knob_values[i]);
+	}
+	return result;
+}
+
+/*
+ * Simulate one configuration of a parameter sweep. This is the task run by the thread pool.
+ *
+ * argument:	a pointer to the sweep_point describing the configuration
+ */
+static void sweep_task(void* argument) {
+	struct sweep_point* point = (struct sweep_point*) argument;
+
+	/* Every task has its own memory pool and its own copy of the remaining times, and only the averages are
+	 * kept, so the results of the individual processes are discarded. */
+	struct arena* pool = create_arena();
+	struct output_writer* output = open_output_writer(NULL, OUTPUT_NONE, 0, pool);
+	struct arrival_stream arrivals;
+	init_table_stream(&arrivals, copy_process_table(point->table, pool));
+	point->results.latency = NULL;
+	point->results.checkpoint = NULL;
+	point->results.what_if = NULL;
+	simulate(point->policy, &point->params, &arrivals, output, pool, &point->results);
+	close_output_writer(output);
+	destroy_arena(pool);
+}
+
+/*
+ * Simulate every configuration of a parameter sweep on a work-stealing thread pool, then write one line of
+ * CSV per configuration with its parameters and averages.
+ *
+ * points:		an array of configurations, whose table field must be set
+ * num_points:	the number of configurations
+ * num_threads:	the number of worker threads
+ * csv_path:	the path of the CSV file to write
+ *
+ * Returns: 0 on success, -1 if the CSV file cannot be written (an error statement is printed out in that case)
+ */
+int run_sweep(struct sweep_point* points, int num_points, int num_threads, const char* csv_path) {
+	struct thread_pool* pool = create_thread_pool(num_threads);
+	for (int i = 0; i < num_points; i++) {
+		thread_pool_submit(pool, sweep_task, &points[i]);
+	}
+	destroy_thread_pool(pool);
+
+	FILE* csv_file = fopen(csv_path, "w");
+	if (csv_file == NULL) {
+		printf("ERROR: Cannot open/create file \"%s\"\n", csv_path);
+		return -1;
+	}
+	fprintf(csv_file, "policy,quantum,levels,boost,aging,average_turnaround,average_normalized_turnaround,average_waiting\n");
+	for (int i = 0; i < num_points; i++) {
+		const struct sim_results* results = &points[i].results;
+		int count = results->num_processes > 0 ? results->num_processes : 1;
+		fprintf(csv_file, "%s,%ld,%d,%ld,%ld,%f,%f,%f\n", points[i].policy->name, points[i].params.quantum, points[i].params.num_levels, points[i].params.boost_interval, points[i].params.aging_interval, sum_value(&results->sum_turnaround)/count, sum_value(&results->sum_normalized_turnaround)/count, sum_value(&results->sum_waiting)/count);
+	}
+	if (fclose(csv_file) != 0) {
+		printf("ERROR: Cannot write file \"%s\"\n", csv_path);
+		return -1;
+	}
+	return 0;
+}
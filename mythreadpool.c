@@ -0,0 +1,267 @@
+/**
+ * Implementation of a work-stealing thread pool. Every worker thread has a queue of its own: it takes the
+ * tasks it owns from the front, and when it runs out of them it steals tasks from the front of the queues of
+ * the other workers, so that long and short tasks even out across the workers. Since every task is taken
+ * from the front, tasks start in about the order they were submitted.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <unistd.h>
+#include "mydispatcher.h"
+
+/* Representation of a task run by a thread pool. */
+struct task {
+	void (*run)(void* argument);	// the function to run
+	void* argument;					// the argument passed to the function
+};
+
+/* Representation of the deque of tasks owned by one worker thread (implemented with a growable circular
+ * array). Tasks are added to the back, and both the owner and other workers stealing them take them from the
+ * front, oldest first. */
+struct task_deque {
+	struct task* tasks;			// the tasks, stored circularly
+	int capacity;				// the number of tasks the array can hold before it has to grow
+	int front;					// the position of the task at the front
+	int size;					// the number of tasks in the deque
+	pthread_mutex_t lock;		// protects the deque
+};
+
+/* Representation of a worker thread of a thread pool. */
+struct worker {
+	struct thread_pool* owner;	// the thread pool the worker belongs to
+	int index;					// the index of the worker in the thread pool
+	struct task_deque deque;	// the tasks owned by the worker
+	pthread_t thread;			// the thread of the worker
+};
+
+/* Representation of a thread pool. */
+struct thread_pool {
+	struct worker* workers;		// the worker threads
+	int num_workers;			// the number of worker threads
+	int next_worker;			// the worker the next submitted task is given to
+	int num_pending;			// the number of tasks submitted but not yet finished
+	int num_queued;				// the number of tasks waiting in some deque
+	int stopping;				// whether the workers should stop
+	pthread_mutex_t lock;		// protects the counters and the stopping flag
+	pthread_cond_t work_available;	// signalled when a task is submitted or the pool stops
+	pthread_cond_t all_done;		// signalled when the last pending task finishes
+};
+
+/*
+ * Add a task to the back of a deque.
+ *
+ * deque:	a pointer to the deque
+ * task:	the task to be added
+ */
+static void push_task(struct task_deque* deque, struct task task) {
+	pthread_mutex_lock(&deque->lock);
+	if (deque->size == deque->capacity) {
+		/* If the array is full, double its capacity and straighten out the circular order. */
+		int new_capacity = deque->capacity * 2;
+		struct task* new_tasks = (struct task*) malloc(new_capacity * sizeof(struct task));
+		for (int i = 0; i < deque->size; i++) {
+			new_tasks[i] = deque->tasks[(deque->front + i) % deque->capacity];
+		}
+		free(deque->tasks);
+		deque->tasks = new_tasks;
+		deque->capacity = new_capacity;
+		deque->front = 0;
+	}
+	deque->tasks[(deque->front + deque->size) % deque->capacity] = task;
+	deque->size++;
+	pthread_mutex_unlock(&deque->lock);
+}
+
+/*
+ * Take the task at the front of a deque, which is the oldest one in it.
+ *
+ * deque:	a pointer to the deque
+ * task:	a pointer to where the task is stored
+ *
+ * Returns: 1 if a task was taken, 0 if the deque is empty
+ */
+static int take_task(struct task_deque* deque, struct task* task) {
+	int taken = 0;
+	pthread_mutex_lock(&deque->lock);
+	if (deque->size > 0) {
+		*task = deque->tasks[deque->front];
+		deque->front = (deque->front + 1) % deque->capacity;
+		deque->size--;
+		taken = 1;
+	}
+	pthread_mutex_unlock(&deque->lock);
+	return taken;
+}
+
+/*
+ * Find a task for a worker: first from its own deque, then by stealing from the other workers in turn.
+ *
+ * current_worker:	a pointer to the worker
+ * task:			a pointer to where the task is stored
+ *
+ * Returns: 1 if a task was found, 0 otherwise
+ */
+static int find_task(struct worker* current_worker, struct task* task) {
+	struct thread_pool* pool = current_worker->owner;
+	if (take_task(&current_worker->deque, task)) {
+		return 1;
+	}
+	for (int i = 1; i < pool->num_workers; i++) {
+		struct worker* victim = &pool->workers[(current_worker->index + i) % pool->num_workers];
+		if (take_task(&victim->deque, task)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * The function run by every worker thread. It runs tasks until the thread pool stops, and sleeps while there
+ * is no task to run.
+ *
+ * argument:	a pointer to the worker
+ *
+ * Returns: NULL
+ */
+static void* worker_main(void* argument) {
+	struct worker* current_worker = (struct worker*) argument;
+	struct thread_pool* pool = current_worker->owner;
+	while (1) {
+		pthread_mutex_lock(&pool->lock);
+		while (pool->num_queued == 0 && !pool->stopping) {
+			pthread_cond_wait(&pool->work_available, &pool->lock);
+		}
+		if (pool->num_queued == 0) {
+			pthread_mutex_unlock(&pool->lock);
+			break;
+		}
+		pthread_mutex_unlock(&pool->lock);
+
+		struct task task;
+		if (find_task(current_worker, &task)) {
+			pthread_mutex_lock(&pool->lock);
+			pool->num_queued--;
+			pthread_mutex_unlock(&pool->lock);
+
+			task.run(task.argument);
+
+			pthread_mutex_lock(&pool->lock);
+			if (--pool->num_pending == 0) {
+				pthread_cond_broadcast(&pool->all_done);
+			}
+			pthread_mutex_unlock(&pool->lock);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Get the number of processors available, which is the default number of worker threads.
+ *
+ * Returns: the number of processors (at least 1)
+ */
+int num_processors() {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int) count : 1;
+}
+
+/*
+ * Create a thread pool and start its worker threads.
+ *
+ * num_workers:	the number of worker threads
+ *
+ * Returns: a pointer to the thread pool
+ */
+struct thread_pool* create_thread_pool(int num_workers) {
+	struct thread_pool* pool = (struct thread_pool*) malloc(sizeof(struct thread_pool));
+	pool->workers = (struct worker*) malloc(num_workers * sizeof(struct worker));
+	pool->num_workers = num_workers;
+	pool->next_worker = 0;
+	pool->num_pending = 0;
+	pool->num_queued = 0;
+	pool->stopping = 0;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->work_available, NULL);
+	pthread_cond_init(&pool->all_done, NULL);
+
+	/* Set up every deque before starting any thread, since the threads steal from each other. */
+	for (int i = 0; i < num_workers; i++) {
+		struct worker* current_worker = &pool->workers[i];
+		current_worker->owner = pool;
+		current_worker->index = i;
+		current_worker->deque.capacity = 16;
+		current_worker->deque.tasks = (struct task*) malloc(current_worker->deque.capacity * sizeof(struct task));
+		current_worker->deque.front = 0;
+		current_worker->deque.size = 0;
+		pthread_mutex_init(&current_worker->deque.lock, NULL);
+	}
+	for (int i = 0; i < num_workers; i++) {
+		pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]);
+	}
+	return pool;
+}
+
+/*
+ * Submit a task to a thread pool. Tasks are given to the workers in turn, and idle workers steal them from
+ * busy ones.
+ *
+ * pool:		a pointer to the thread pool
+ * run:			the function to run
+ * argument:	the argument passed to the function
+ */
+void thread_pool_submit(struct thread_pool* pool, void (*run)(void* argument), void* argument) {
+	struct task task = { run, argument };
+	pthread_mutex_lock(&pool->lock);
+	int target = pool->next_worker;
+	pool->next_worker = (pool->next_worker + 1) % pool->num_workers;
+	pool->num_pending++;
+	pthread_mutex_unlock(&pool->lock);
+
+	/* The task is pushed before it is counted as queued, so that a worker woken up for it can find it. */
+	push_task(&pool->workers[target].deque, task);
+	pthread_mutex_lock(&pool->lock);
+	pool->num_queued++;
+	pthread_cond_signal(&pool->work_available);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+ * Wait until every task submitted to a thread pool has finished.
+ *
+ * pool:	a pointer to the thread pool
+ */
+void thread_pool_wait(struct thread_pool* pool) {
+	pthread_mutex_lock(&pool->lock);
+	while (pool->num_pending > 0) {
+		pthread_cond_wait(&pool->all_done, &pool->lock);
+	}
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+ * Stop the worker threads of a thread pool once every submitted task has finished, and deallocate it.
+ *
+ * pool:	a pointer to the thread pool
+ */
+void destroy_thread_pool(struct thread_pool* pool) {
+	thread_pool_wait(pool);
+	pthread_mutex_lock(&pool->lock);
+	pool->stopping = 1;
+	pthread_cond_broadcast(&pool->work_available);
+	pthread_mutex_unlock(&pool->lock);
+	for (int i = 0; i < pool->num_workers; i++) {
+		pthread_join(pool->workers[i].thread, NULL);
+		pthread_mutex_destroy(&pool->workers[i].deque.lock);
+		free(pool->workers[i].deque.tasks);
+	}
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->work_available);
+	pthread_cond_destroy(&pool->all_done);
+	free(pool->workers);
+	free(pool);
+}
@@ -6,44 +6,132 @@
  * - Course: COMP 354: Operating Systems
  * - Instructor: Shikha Mittal
  * - Date created: 05/15/2020
- * - Last updated: 05/28/2020
+ * - Last updated: 10/17/2026
  */
 
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 #include "mydispatcher.h"
 
 /*
- * Create a new process from a specified ID, arrival time and service time.
+ * Create a new, empty table of processes.
  *
- * process_id:		ID of the process
+ * pool:	a pointer to the memory pool that owns the table and its columns
+ *
+ * Returns: a pointer to the created table
+ */
+struct process_table* create_process_table(struct arena* pool) {
+	struct process_table* created_table = (struct process_table*) arena_alloc(pool, sizeof(struct process_table));
+
+	/* Start with small columns, which are grown by doubling whenever they become full. */
+	created_table->capacity = 64;
+	created_table->size = 0;
+	created_table->pool = pool;
+	created_table->id = (int*) arena_alloc(pool, created_table->capacity * sizeof(int));
+	created_table->arrival_time = (long*) arena_alloc(pool, created_table->capacity * sizeof(long));
+	created_table->service_time = (long*) arena_alloc(pool, created_table->capacity * sizeof(long));
+	created_table->remaining_time = (long*) arena_alloc(pool, created_table->capacity * sizeof(long));
+	created_table->free_slots = (int*) arena_alloc(pool, created_table->capacity * sizeof(int));
+	created_table->num_free = 0;
+
+	return created_table;
+}
+
+/*
+ * Add a new process with a specified arrival time and service time to the end of a specified table. The ID
+ * of the process is its line number in the input, which is always 1 more than its index in the table.
+ *
+ * table:			a pointer to the table to add the process to
  * process_arrival:	arrival time of the process
  * process_service:	service time of the process
  *
- * Returns:	a pointer to the created process
+ * Returns: the index of the added process in the table
  */
-struct process* create_process(int process_id, int process_arrival, int process_service) {
-	struct process* created_process = (struct process*) malloc(sizeof(struct process));
-	created_process->id = process_id;
-	created_process->arrival_time = process_arrival;
-	created_process->service_time = process_service;
+int process_table_add(struct process_table* table, long process_arrival, long process_service) {
+	if (table->size == table->capacity) {
+		/* If the columns are full, double their capacity. */
+		size_t old_size = table->capacity * sizeof(int);
+		size_t new_size = 2 * old_size;
+		size_t old_time_size = table->capacity * sizeof(long);
+		size_t new_time_size = 2 * old_time_size;
+		table->id = (int*) arena_grow(table->pool, table->id, old_size, new_size);
+		table->arrival_time = (long*) arena_grow(table->pool, table->arrival_time, old_time_size, new_time_size);
+		table->service_time = (long*) arena_grow(table->pool, table->service_time, old_time_size, new_time_size);
+		table->remaining_time = (long*) arena_grow(table->pool, table->remaining_time, old_time_size, new_time_size);
+		table->free_slots = (int*) arena_grow(table->pool, table->free_slots, table->num_free * sizeof(int), new_size);
+		table->capacity *= 2;
+	}
+
+	int index = table->size;
+	table->id[index] = index + 1;
+	table->arrival_time[index] = process_arrival;
+	table->service_time[index] = process_service;
 
 	/* Since the process is not run yet, remaining time is initialized to be the same as service time. */
-	created_process->remaining_time = process_service;
+	table->remaining_time[index] = process_service;
 
-	return created_process;
+	table->size++;
+	return index;
+}
+
+/*
+ * Put a new process with a specified ID, arrival time and service time into a row of a specified table that
+ * has been released, or into a new row at the end if no row has been released. This keeps the table only as
+ * large as the largest number of processes alive at once.
+ *
+ * table:			a pointer to the table to put the process into
+ * process_id:		ID of the process
+ * process_arrival:	arrival time of the process
+ * process_service:	service time of the process
+ *
+ * Returns: the index of the row the process is put into
+ */
+int process_table_acquire(struct process_table* table, int process_id, long process_arrival, long process_service) {
+	int index;
+	if (table->num_free > 0) {
+		/* Reuse the most recently released row. */
+		index = table->free_slots[--table->num_free];
+		table->arrival_time[index] = process_arrival;
+		table->service_time[index] = process_service;
+		table->remaining_time[index] = process_service;
+	} else {
+		index = process_table_add(table, process_arrival, process_service);
+	}
+	table->id[index] = process_id;
+	return index;
+}
+
+/*
+ * Release a row of a specified table, whose process has completed, so that a later call to
+ * process_table_acquire() can reuse it.
+ *
+ * table:	a pointer to the table the row belongs to
+ * index:	the index of the row to be released
+ */
+void process_table_release(struct process_table* table, int index) {
+	table->free_slots[table->num_free++] = index;
 }
 
 /*
  * Create a new queue of processes.
  *
+ * pool:	a pointer to the memory pool that owns the queue and its nodes
+ *
  * Returns: a pointer to the created queue
  */
-struct queue* create_queue() {
-	struct queue* created_queue = (struct queue*) malloc(sizeof(struct queue));
+struct queue* create_queue(struct arena* pool) {
+	struct queue* created_queue = (struct queue*) arena_alloc(pool, sizeof(struct queue));
 
 	/* Initialize the head of rear of the queue to NULL. Set the size of the queue to 0. */
 	created_queue->head = NULL;
 	created_queue->rear = NULL;
 	created_queue->size = 0;
+	created_queue->pool = pool;
 
 	return created_queue;
 }
@@ -52,11 +140,12 @@ struct queue* create_queue() {
  * Add a specified process to the end of a specified queue.
  *
  * current_queue:	a pointer to the queue to add the process to
- * process_to_add:	a pointer to the process to be added
+ * process_to_add:	the index of the process to be added
  */
-void enqueue(struct queue* current_queue, struct process* process_to_add) {
-	/* Create a node from the process. Initialize both its previous and next nodes to NULL. */
-	struct node* node_to_add = (struct node*) malloc(sizeof(struct node));
+void enqueue(struct queue* current_queue, int process_to_add) {
+	/* Create a node from the process, reusing a released node if possible. Initialize both its previous and
+	 * next nodes to NULL. */
+	struct node* node_to_add = arena_alloc_node(current_queue->pool);
 	node_to_add->data = process_to_add;
 	node_to_add->prev = NULL;
 	node_to_add->next = NULL;
@@ -79,110 +168,697 @@ void enqueue(struct queue* current_queue, struct process* process_to_add) {
 }
 
 /*
- * Re-sort a specified queue by the remaining time of processes. This function should be called right after
- * adding a process to the queue, and it takes advantage of the fact that the queue is already sorted before
- * the process is added.
+ * Retrive and remove the first (frontmost) process of a queue.
+ *
+ * current_queue:	a pointer to the queue to remove the frontmost process from
  *
- * current_queue:	a pointer to the queue to be re-sorted
+ * Returns: the index of the removed process, or -1 if the queue is empty
  */
-void resort_after_adding(struct queue* current_queue) {
-	struct node* added_node = current_queue->rear;			// a pointer to the node just added to the queue
-	while (added_node->prev != NULL) {
-		if (added_node->prev->data->remaining_time > added_node->data->remaining_time) {
-			/* If the remaining time of the process refered to by the previous node is longer than that of
-			 * the added process, move the added process towards the front of the queue by swapping the
-			 * positions of its node and the previous node. */
-			struct node* node_to_swap = added_node->prev;
+int dequeue(struct queue* current_queue) {
+	if (current_queue->size == 0) {
+		/* If the queue is empty, returns -1. */
+		return -1;
+	} else {
+		int process_to_return = current_queue->head->data;	// hold the process to be returned
+		struct node* node_to_remove = current_queue->head;				// hold the node to be removed
 
-			/* Update all needed pointers. */
-			if (node_to_swap->prev != NULL) {
-				node_to_swap->prev->next = added_node;
-			} else {
-				current_queue->head = added_node;
+		/* Make the head of the queue become the node after the current head, or NULL if no such node
+		 * exists. */
+		current_queue->head = node_to_remove->next;
+		if (current_queue->head == NULL) {
+			/* If the head becomes NULL, make the rear also become NULL since the queue is now empty. */
+			current_queue->rear = NULL;
+		} else {
+			/* If the head is not NULL, change the previous node of the head to NULL. */
+			current_queue->head->prev = NULL;
+		}
+
+		/* Decrease the size of the queue and give the removed node back to the memory pool for reuse. */
+		current_queue->size--;
+		arena_release_node(current_queue->pool, node_to_remove);
+		return process_to_return;
+	}
+}
+
+/*
+ * Compare two entries of a priority queue.
+ *
+ * first_entry:		a pointer to the first entry
+ * second_entry:	a pointer to the second entry
+ *
+ * Returns: 1 if the first entry should be retrieved before the second entry, 0 otherwise
+ */
+static int heap_entry_before(const struct heap_entry* first_entry, const struct heap_entry* second_entry) {
+	/* Processes with a shorter remaining time come first. Among processes with the same remaining time, the
+	 * one added earlier comes first, which is the same order a sorted queue keeps. */
+	if (first_entry->key != second_entry->key) {
+		return first_entry->key < second_entry->key;
+	}
+	return first_entry->order < second_entry->order;
+}
+
+/*
+ * Create a new priority queue of processes.
+ *
+ * pool:	a pointer to the memory pool that owns the priority queue and its array
+ *
+ * Returns: a pointer to the created priority queue
+ */
+struct heap* create_heap(struct arena* pool) {
+	struct heap* created_heap = (struct heap*) arena_alloc(pool, sizeof(struct heap));
+
+	/* Start with a small array, which is grown by doubling whenever it becomes full. */
+	created_heap->capacity = 16;
+	created_heap->entries = (struct heap_entry*) arena_alloc(pool, created_heap->capacity * sizeof(struct heap_entry));
+	created_heap->size = 0;
+	created_heap->num_unsorted = 0;
+	created_heap->next_order = 0;
+	created_heap->pool = pool;
+
+	return created_heap;
+}
+
+/*
+ * Add a specified process to a specified priority queue with a specified key, which is the remaining time
+ * of the process for SPN and SRT.
+ *
+ * current_heap:	a pointer to the priority queue to add the process to
+ * process_to_add:	the index of the process to be added
+ * key:				the key the priority queue is ordered on
+ */
+void heap_insert(struct heap* current_heap, int process_to_add, long key) {
+	if (current_heap->size == current_heap->capacity) {
+		/* If the array is full, double its capacity. */
+		size_t old_size = current_heap->capacity * sizeof(struct heap_entry);
+		current_heap->capacity *= 2;
+		current_heap->entries = (struct heap_entry*) arena_grow(current_heap->pool, current_heap->entries, old_size, current_heap->capacity * sizeof(struct heap_entry));
+	}
+	if (current_heap->num_unsorted > 0) {
+		heap_fix(current_heap);
+	}
+
+	struct heap_entry added_entry;		// the entry to be added
+	added_entry.data = process_to_add;
+	added_entry.key = key;
+	added_entry.order = current_heap->next_order++;
+
+	/* Start from the first free position and move the parents of that position down until the parent
+	 * should come before the added entry (sift up). */
+	int position = current_heap->size;
+	METRIC_ADD(heap_inserts, 1);
+	while (position > 0) {
+		int parent = (position - 1) / 2;
+		METRIC_ADD(heap_comparisons, 1);
+		if (!heap_entry_before(&added_entry, &current_heap->entries[parent])) {
+			break;
+		}
+		current_heap->entries[position] = current_heap->entries[parent];
+		METRIC_ADD(heap_moves, 1);
+		position = parent;
+	}
+	current_heap->entries[position] = added_entry;
+
+	/* Increase the size of the priority queue after adding. */
+	current_heap->size++;
+}
+
+/*
+ * Add a specified process to a specified priority queue with a specified key, without moving it into place
+ * yet. The processes added this way are moved into place all at once the next time the priority queue is
+ * looked at, which is cheaper than adding them one by one when many arrive at the same time. The order they
+ * come out in is the same as if they had been added with heap_insert().
+ *
+ * current_heap:	a pointer to the priority queue to add the process to
+ * process_to_add:	the index of the process to be added
+ * key:				the key the priority queue is ordered on
+ */
+void heap_append(struct heap* current_heap, int process_to_add, long key) {
+	if (current_heap->size == current_heap->capacity) {
+		/* If the array is full, double its capacity. */
+		size_t old_size = current_heap->capacity * sizeof(struct heap_entry);
+		current_heap->capacity *= 2;
+		current_heap->entries = (struct heap_entry*) arena_grow(current_heap->pool, current_heap->entries, old_size, current_heap->capacity * sizeof(struct heap_entry));
+	}
+	struct heap_entry* added_entry = &current_heap->entries[current_heap->size++];
+	added_entry->data = process_to_add;
+	added_entry->key = key;
+	added_entry->order = current_heap->next_order++;
+	current_heap->num_unsorted++;
+	METRIC_ADD(heap_inserts, 1);
+}
+
+/*
+ * Move the processes added with heap_append() into place. If they are at least as many as the processes
+ * already in place, the whole array is rebuilt from the bottom up (Floyd's method), which takes linear time;
+ * otherwise each of them is moved up from the end of the array, as in heap_insert().
+ *
+ * current_heap:	a pointer to the priority queue
+ */
+void heap_fix(struct heap* current_heap) {
+	int num_sorted = current_heap->size - current_heap->num_unsorted;
+	current_heap->num_unsorted = 0;
+	if (current_heap->size - num_sorted >= num_sorted) {
+		/* Move every entry that has children down until both of its children come after it (sift down),
+		 * starting from the last one. */
+		for (int start = current_heap->size / 2 - 1; start >= 0; start--) {
+			struct heap_entry moved_entry = current_heap->entries[start];
+			int position = start;
+			while (1) {
+				int child = 2 * position + 1;
+				if (child >= current_heap->size) {
+					break;
+				}
+				if (child + 1 < current_heap->size) {
+					METRIC_ADD(heap_comparisons, 1);
+					if (heap_entry_before(&current_heap->entries[child+1], &current_heap->entries[child])) {
+						child++;
+					}
+				}
+				METRIC_ADD(heap_comparisons, 1);
+				if (!heap_entry_before(&current_heap->entries[child], &moved_entry)) {
+					break;
+				}
+				current_heap->entries[position] = current_heap->entries[child];
+				METRIC_ADD(heap_moves, 1);
+				position = child;
 			}
-			if (added_node->next != NULL) {
-				added_node->next->prev = node_to_swap;
-			} else {
-				current_queue->rear = node_to_swap;
+			current_heap->entries[position] = moved_entry;
+		}
+		return;
+	}
+
+	for (int added = num_sorted; added < current_heap->size; added++) {
+		struct heap_entry added_entry = current_heap->entries[added];
+		int position = added;
+		while (position > 0) {
+			int parent = (position - 1) / 2;
+			METRIC_ADD(heap_comparisons, 1);
+			if (!heap_entry_before(&added_entry, &current_heap->entries[parent])) {
+				break;
+			}
+			current_heap->entries[position] = current_heap->entries[parent];
+			METRIC_ADD(heap_moves, 1);
+			position = parent;
+		}
+		current_heap->entries[position] = added_entry;
+	}
+}
+
+/*
+ * Retrieve (without removing) the process with the smallest key in a priority queue.
+ *
+ * current_heap:	a pointer to the priority queue
+ *
+ * Returns: the index of the process, or -1 if the priority queue is empty
+ */
+int heap_peek(struct heap* current_heap) {
+	if (current_heap->size == 0) {
+		return -1;
+	}
+	if (current_heap->num_unsorted > 0) {
+		heap_fix(current_heap);
+	}
+	return current_heap->entries[0].data;
+}
+
+/*
+ * Retrieve (without removing) the smallest key in a priority queue. The priority queue must not be empty.
+ *
+ * current_heap:	a pointer to the priority queue
+ *
+ * Returns: the smallest key
+ */
+long heap_peek_key(struct heap* current_heap) {
+	if (current_heap->num_unsorted > 0) {
+		heap_fix(current_heap);
+	}
+	return current_heap->entries[0].key;
+}
+
+/*
+ * Retrieve and remove the process with the smallest key in a priority queue.
+ *
+ * current_heap:	a pointer to the priority queue to remove the process from
+ *
+ * Returns: the index of the removed process, or -1 if the priority queue is empty
+ */
+int heap_extract_min(struct heap* current_heap) {
+	if (current_heap->size == 0) {
+		/* If the priority queue is empty, returns -1. */
+		return -1;
+	}
+	if (current_heap->num_unsorted > 0) {
+		heap_fix(current_heap);
+	}
+
+	int process_to_return = current_heap->entries[0].data;	// hold the process to be returned
+
+	/* Decrease the size of the priority queue, then move the last entry into the root position and move it
+	 * down until both of its children come after it (sift down). */
+	current_heap->size--;
+	if (current_heap->size > 0) {
+		struct heap_entry moved_entry = current_heap->entries[current_heap->size];
+		int position = 0;
+		while (1) {
+			int child = 2 * position + 1;
+			if (child >= current_heap->size) {
+				break;
+			}
+			if (child + 1 < current_heap->size && heap_entry_before(&current_heap->entries[child+1], &current_heap->entries[child])) {
+				child++;
 			}
-			node_to_swap->next = added_node->next;
-			added_node->prev = node_to_swap->prev;
-			node_to_swap->prev = added_node;
-			added_node->next = node_to_swap;
+			if (!heap_entry_before(&current_heap->entries[child], &moved_entry)) {
+				break;
+			}
+			current_heap->entries[position] = current_heap->entries[child];
+			position = child;
+		}
+		current_heap->entries[position] = moved_entry;
+	}
+
+	return process_to_return;
+}
+
+/*
+ * Get the current time of a monotonic clock, used for measuring how long parts of the program take.
+ *
+ * Returns: the current time in seconds
+ */
+double current_seconds() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/*
+ * Read a non-negative decimal integer at a specified position of the input.
+ *
+ * cursor:	a pointer to the position to read from, which is moved past the integer
+ * end:		the end of the input
+ * value:	a pointer to where the integer is stored
+ *
+ * Returns: 1 if an integer that fits in a long was read, 0 otherwise
+ */
+static int scan_integer(const char** cursor, const char* end, long* value) {
+	const char* current = *cursor;
+	long result = 0;
+	if (current == end || *current < '0' || *current > '9') {
+		return 0;
+	}
+	while (current < end && *current >= '0' && *current <= '9') {
+		int digit = *current - '0';
+		if (result > (LONG_MAX - digit) / 10) {
+			/* The integer is too large for a long. */
+			return 0;
+		}
+		result = result * 10 + digit;
+		current++;
+	}
+	*cursor = current;
+	*value = result;
+	return 1;
+}
+
+/*
+ * Read one line of input, which should consist of two space-separated non-negative integers. The line may
+ * end with a newline (optionally preceded by a carriage return) or with the end of the input.
+ *
+ * cursor:			a pointer to the start of the line, which is moved to the start of the next line
+ * end:				the end of the input
+ * read_arrival:	a pointer to where the first integer (arrival time) is stored
+ * read_service:	a pointer to where the second integer (service time) is stored
+ *
+ * Returns: SCAN_PROCESS if a process was read, SCAN_BLANK if the line only contains whitespace, or
+ *			SCAN_MALFORMED if the line does not have the correct format
+ */
+int scan_input_line(const char** cursor, const char* end, long* read_arrival, long* read_service) {
+	const char* current = *cursor;
+	int result = SCAN_PROCESS;
+
+	/* Skip leading spaces. A line with nothing else on it is blank. */
+	while (current < end && (*current == ' ' || *current == '\t' || *current == '\r')) {
+		current++;
+	}
+	if (current == end || *current == '\n') {
+		result = SCAN_BLANK;
+	} else if (!scan_integer(&current, end, read_arrival)) {
+		result = SCAN_MALFORMED;
+	} else {
+		/* The two integers have to be separated by at least one space. */
+		const char* separator = current;
+		while (current < end && (*current == ' ' || *current == '\t')) {
+			current++;
+		}
+		if (current == separator || !scan_integer(&current, end, read_service)) {
+			result = SCAN_MALFORMED;
 		} else {
-			/* If the added process is already at the head of the queue, or the remaining time of the process
-			 * refered to by the previous node is not longer than that of the added process, then the queue
-			 * is already sorted. */
-			break;
+			/* Only trailing spaces may follow the second integer. */
+			while (current < end && (*current == ' ' || *current == '\t' || *current == '\r')) {
+				current++;
+			}
+			if (current < end && *current != '\n') {
+				result = SCAN_MALFORMED;
+			}
 		}
 	}
+
+	/* Move past the rest of the line, including its newline. */
+	const char* newline = memchr(current, '\n', end - current);
+	*cursor = newline != NULL ? newline + 1 : end;
+	return result;
 }
 
 /*
- * Add a specified process to the end of a specified queue and then re-sort the queue. This function should
- * be called for adding a process if the queue needs to be sorted at all times.
+ * Check the result of reading one line of input against the rules of the input format, and describe the
+ * problem if a rule is broken. Blank lines are only allowed at the end of the input, since the line number of
+ * a process is its ID, and arrival times must never decrease. No policy keeps the CPU idle while a process is
+ * ready, so every process finishes by the time a single CPU running all processes so far in order of arrival
+ * would be done with them; that bound must fit in a long, so that no time of the simulation overflows.
  *
- * current_queue:	a pointer to the queue to add the process to
- * process_to_add:	a pointer to the process to be added
+ * result:			the result of scan_input_line() for the line
+ * line_number:		the number of the line
+ * blank_line:		a pointer to the number of the first blank line so far (0 if none), which is updated
+ * last_arrival:	the arrival time of the process on the line before, or -1 if there is none
+ * read_arrival:	the arrival time read from the line
+ * read_service:	the service time read from the line
+ * finish_bound:	a pointer to the time all processes so far have finished by (0 if none), which is updated
+ * input_path:		the path of the input, used in error messages
+ * error:			a buffer of INPUT_ERROR_MAX characters where an error message is written if a rule is broken
+ *
+ * Returns: 1 if the line holds a valid process, 0 if it is blank, or -1 if the input is malformed
  */
-void enqueue_with_sorting(struct queue* current_queue, struct process* process_to_add) {
-	enqueue(current_queue, process_to_add);
-	resort_after_adding(current_queue);
+static int check_input_line(int result, int line_number, int* blank_line, long last_arrival, long read_arrival, long read_service, long* finish_bound, const char* input_path, char* error) {
+	if (result == SCAN_BLANK) {
+		/* Remember the first blank line in case a process follows. */
+		if (*blank_line == 0) {
+			*blank_line = line_number;
+		}
+		return 0;
+	} else if (result == SCAN_MALFORMED || *blank_line != 0) {
+		snprintf(error, INPUT_ERROR_MAX, "Line %d of \"%s\" is not two space-separated non-negative integers!", result == SCAN_MALFORMED ? line_number : *blank_line, input_path);
+		return -1;
+	} else if (read_arrival < last_arrival) {
+		snprintf(error, INPUT_ERROR_MAX, "The arrival time on line %d of \"%s\" is earlier than the one on the line before!", line_number, input_path);
+		return -1;
+	}
+	long start = *finish_bound > read_arrival ? *finish_bound : read_arrival;
+	if (read_service > LONG_MAX - start) {
+		snprintf(error, INPUT_ERROR_MAX, "The processes up to line %d of \"%s\" may finish later than time %ld!", line_number, input_path, LONG_MAX);
+		return -1;
+	}
+	*finish_bound = start + read_service;
+	return 1;
 }
 
+/* The size of the chunks an input reader reads at once, which also limits the length of a line. */
+#define READER_CHUNK_SIZE (256 * 1024)
+
 /*
- * Retrive and remove the first (frontmost) process of a queue.
+ * Open a reader on a specified input file, or on stdin if the path is "-". The reader works on pipes as
+ * well as regular files and only keeps one chunk of the input in memory.
  *
- * current_queue:	a pointer to the queue to remove the frontmost process from
+ * input_path:		the path of the file to read input from
+ * pool:			a pointer to the memory pool that owns the reader and its buffer
  *
- * Returns: a pointer to the removed process
+ * Returns: a pointer to the reader, or NULL if the file cannot be opened (an error statement is printed out
+ *			in that case)
  */
-struct process* dequeue(struct queue* current_queue) {
-	if (current_queue->size == 0) {
-		/* If the queue is empty, returns NULL. */
+struct input_reader* open_input_reader(const char* input_path, struct arena* pool) {
+	int input_fd = strcmp(input_path, "-") == 0 ? STDIN_FILENO : open(input_path, O_RDONLY);
+	if (input_fd < 0) {
+		printf("ERROR: Cannot open file \"%s\"!\n", input_path);
 		return NULL;
-	} else {
-		struct process* process_to_return = current_queue->head->data;	// hold the process to be returned
-		struct node* node_to_remove = current_queue->head;				// hold the node to be removed
+	}
 
-		/* Make the head of the queue become the node after the current head, or NULL if no such node
-		 * exists. */
-		current_queue->head = node_to_remove->next;
-		if (current_queue->head == NULL) {
-			/* If the head becomes NULL, make the rear also become NULL since the queue is now empty. */
-			current_queue->rear = NULL;
-		} else {
-			/* If the head is not NULL, change the previous node of the head to NULL. */
-			current_queue->head->prev = NULL;
+	struct input_reader* reader = (struct input_reader*) arena_alloc(pool, sizeof(struct input_reader));
+	reader->fd = input_fd;
+	reader->path = input_path;
+	reader->capacity = READER_CHUNK_SIZE;
+	reader->buffer = (char*) arena_alloc(pool, reader->capacity);
+	reader->start = 0;
+	reader->end = 0;
+	reader->end_of_input = 0;
+	reader->line_number = 0;
+	reader->blank_line = 0;
+	reader->num_processes = 0;
+	reader->last_arrival = -1;
+	reader->finish_bound = 0;
+	reader->error = 0;
+	reader->num_bytes = 0;
+	return reader;
+}
+
+/*
+ * Read the next process from a specified reader, reading more of the input whenever the buffer holds no
+ * complete line.
+ *
+ * reader:			a pointer to the reader
+ * read_arrival:	a pointer to where the arrival time of the process is stored
+ * read_service:	a pointer to where the service time of the process is stored
+ *
+ * Returns: 1 if a process was read, 0 at the end of the input or if the input is malformed (the error field
+ *			of the reader is set and an error statement is printed out in that case)
+ */
+int reader_next_process(struct input_reader* reader, long* read_arrival, long* read_service) {
+	while (!reader->error) {
+		/* Find the end of the next line. The last line of the input does not need a newline. */
+		char* line = reader->buffer + reader->start;
+		char* newline = memchr(line, '\n', reader->end - reader->start);
+		if (newline == NULL && !reader->end_of_input) {
+			/* If the buffer holds no complete line, move the partial line to the front of the buffer and fill
+			 * the rest of it from the input. */
+			size_t partial = reader->end - reader->start;
+			if (partial == reader->capacity) {
+				printf("ERROR: Line %d of \"%s\" is too long!\n", reader->line_number + 1, reader->path);
+				reader->error = 1;
+				break;
+			}
+			memmove(reader->buffer, line, partial);
+			reader->start = 0;
+			reader->end = partial;
+			ssize_t num_read = read(reader->fd, reader->buffer + reader->end, reader->capacity - reader->end);
+			if (num_read < 0) {
+				printf("ERROR: Cannot read file \"%s\"!\n", reader->path);
+				reader->error = 1;
+			} else if (num_read == 0) {
+				reader->end_of_input = 1;
+			} else {
+				reader->end += num_read;
+				reader->num_bytes += num_read;
+			}
+			continue;
+		}
+		if (reader->start == reader->end) {
+			/* Everything has been read. */
+			return 0;
 		}
 
-		/* Decrease the size of the queue and deallocate unneeded memory after removing. */
-		current_queue->size--;
-		free(node_to_remove);
-		return process_to_return;
+		/* Parse the line and check it against the rules of the input format. */
+		const char* cursor = line;
+		const char* end = newline != NULL ? newline + 1 : reader->buffer + reader->end;
+		reader->line_number++;
+		int result = scan_input_line(&cursor, end, read_arrival, read_service);
+		reader->start = end - reader->buffer;
+		char error[INPUT_ERROR_MAX];
+		int check = check_input_line(result, reader->line_number, &reader->blank_line, reader->last_arrival, *read_arrival, *read_service, &reader->finish_bound, reader->path, error);
+		if (check < 0) {
+			printf("ERROR: %s\n", error);
+			reader->error = 1;
+		} else if (check > 0) {
+			reader->num_processes++;
+			reader->last_arrival = *read_arrival;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Close a specified reader. Its memory is released together with the memory pool that owns it.
+ *
+ * reader:	a pointer to the reader to be closed
+ */
+void close_input_reader(struct input_reader* reader) {
+	if (reader->fd != STDIN_FILENO) {
+		close(reader->fd);
+	}
+}
+
+/*
+ * Start a specified arrival stream over a table that already holds the whole input.
+ *
+ * stream:	a pointer to the stream to be started
+ * table:	a pointer to the table of processes, sorted by arrival time
+ */
+void init_table_stream(struct arrival_stream* stream, struct process_table* table) {
+	stream->table = table;
+	stream->next = 0;
+	stream->reader = NULL;
+}
+
+/*
+ * Start a specified arrival stream that reads processes lazily from a reader. Only the next process to
+ * arrive is read ahead, and each process is put into a row of the table that is released again when the
+ * process completes.
+ *
+ * stream:	a pointer to the stream to be started
+ * table:	a pointer to the (empty) table that holds the processes alive at any time
+ * reader:	a pointer to the reader to take processes from
+ */
+void init_reader_stream(struct arrival_stream* stream, struct process_table* table, struct input_reader* reader) {
+	stream->table = table;
+	stream->reader = reader;
+	advance_reader_stream(stream);
+}
+
+/*
+ * Read the next process of a streaming arrival stream into its table, or mark the end of the stream if the
+ * input has run out.
+ *
+ * stream:	a pointer to the stream
+ */
+void advance_reader_stream(struct arrival_stream* stream) {
+	long read_arrival_time;
+	long read_service_time;
+	if (reader_next_process(stream->reader, &read_arrival_time, &read_service_time)) {
+		stream->next = process_table_acquire(stream->table, stream->reader->num_processes, read_arrival_time, read_service_time);
+	} else {
+		stream->next = -1;
+	}
+}
+
+/*
+ * Create a table of processes from an input that cannot be mapped into memory (stdin or a pipe), by reading
+ * it in chunks with an input reader.
+ *
+ * input_path:		the path of the input, or "-" for stdin
+ * pool:			a pointer to the memory pool that owns the table
+ * stats:			a pointer to where the size of the input and the time spent reading it are stored, or NULL
+ * start_seconds:	the time reading the input started
+ *
+ * Returns: a pointer to the created table of processes, or NULL if the input cannot be read or does not have
+ *			the correct format
+ */
+static struct process_table* read_input_from_reader(const char* input_path, struct arena* pool, struct input_stats* stats, double start_seconds) {
+	struct input_reader* reader = open_input_reader(input_path, pool);
+	if (reader == NULL) {
+		return NULL;
+	}
+	struct process_table* process_table = create_process_table(pool);
+	long read_arrival_time;
+	long read_service_time;
+	while (reader_next_process(reader, &read_arrival_time, &read_service_time)) {
+		process_table_add(process_table, read_arrival_time, read_service_time);
+	}
+	close_input_reader(reader);
+	if (stats != NULL) {
+		stats->bytes = reader->num_bytes;
+		stats->seconds = current_seconds() - start_seconds;
+	}
+	return reader->error ? NULL : process_table;
+}
+
+/*
+ * Create a table of processes to be scheduled from input held in memory, in the format of an input file. The
+ * input is parsed in place, without copying it or allocating anything per line. Since the input is required
+ * to be sorted by arrival time, so is the table.
+ *
+ * input:		a pointer to the first byte of the input (which may be NULL if the input is empty)
+ * input_size:	the number of bytes of the input
+ * input_path:	the path or name of the input, used in error messages
+ * pool:		a pointer to the memory pool that owns the table
+ * error:		a buffer of INPUT_ERROR_MAX characters where an error message is written if the input does not
+ *				have the correct format
+ *
+ * Returns: a pointer to the created table of processes, or NULL if the input does not have the correct format
+ */
+struct process_table* parse_input(const char* input, size_t input_size, const char* input_path, struct arena* pool, char* error) {
+	struct process_table* process_table = create_process_table(pool);	// create a table of processes
+	const char* cursor = input;							// the start of the line to be read next
+	const char* end = input + input_size;				// the end of the input
+	int line_number = 0;								// the number of the line being read
+	int blank_line = 0;									// the number of the first blank line, if any
+	long read_arrival_time;								// hold the arrival time read from the input
+	long read_service_time;								// hold the service time read from the input
+	long last_arrival_time = -1;						// hold the arrival time read from the line before
+	long finish_bound = 0;								// hold the time all processes so far finish by
+	while (cursor < end) {
+		line_number++;
+		int result = scan_input_line(&cursor, end, &read_arrival_time, &read_service_time);
+		int check = check_input_line(result, line_number, &blank_line, last_arrival_time, read_arrival_time, read_service_time, &finish_bound, input_path, error);
+		if (check < 0) {
+			return NULL;
+		} else if (check > 0) {
+			/* Add a new process with the arrival time and service time to the table. */
+			process_table_add(process_table, read_arrival_time, read_service_time);
+			last_arrival_time = read_arrival_time;
+		}
 	}
+	return process_table;
 }
 
 /*
- * Create a list (represented by a queue) of processes to be scheduled from the data in a specified input
- * file.
+ * Create a table of processes to be scheduled from the data in a specified input file. The file is mapped
+ * into memory and parsed in place, without copying it or allocating anything per line. Since the input is
+ * required to be sorted by arrival time, so is the table.
  *
- * input_file:		a pointer to the file to read input from
+ * input_path:		the path of the file to read input from
+ * pool:			a pointer to the memory pool that owns the table
+ * stats:			a pointer to where the size of the input and the time spent reading it are stored, or NULL
  *
- * Returns: a pointer to the created list of processes
+ * Returns: a pointer to the created table of processes, or NULL if the file cannot be read or does not have
+ *			the correct format (an error statement is printed out in that case)
  */
-struct queue* read_input(FILE* input_file) {
-	struct queue* process_list = create_queue();		// create a queue to represent the list of processes
-	int read_arrival_time;								// hold the arrival time read from the input file
-	int read_service_time;								// hold the service time read from the input file
-	while (feof(input_file) == 0) {
-		fscanf(input_file, "%d", &read_arrival_time);	// read the arrival time
-		fscanf(input_file, "%d", &read_service_time);	// read the service time
+struct process_table* read_input(const char* input_path, struct arena* pool, struct input_stats* stats) {
+	double start_seconds = current_seconds();
+
+	if (strcmp(input_path, "-") == 0) {
+		/* stdin cannot be mapped into memory, so read it in chunks instead. */
+		return read_input_from_reader(input_path, pool, stats, start_seconds);
+	}
 
-		/* Create a new process from the arrival time and service time, then add it to the list. Since the
-		 * process ID starts from 1, it is always 1 more than the size of the list before adding. */
-		struct process* current_process = create_process(process_list->size+1, read_arrival_time, read_service_time);
-		enqueue(process_list, current_process);
+	int input_fd = open(input_path, O_RDONLY);
+	struct stat input_info;
+	if (input_fd < 0 || fstat(input_fd, &input_info) != 0) {
+		/* If a problem occurs with opening the file, print out an error statement. */
+		printf("ERROR: Cannot open file \"%s\"!\n", input_path);
+		if (input_fd >= 0) {
+			close(input_fd);
+		}
+		return NULL;
+	}
+	if (!S_ISREG(input_info.st_mode)) {
+		/* A pipe or other special file cannot be mapped into memory either. */
+		close(input_fd);
+		return read_input_from_reader(input_path, pool, stats, start_seconds);
+	}
+
+	/* Map the whole file into memory. An empty file cannot be mapped, but it also has nothing to parse. */
+	size_t input_size = input_info.st_size;
+	const char* input = NULL;
+	if (input_size > 0) {
+		input = mmap(NULL, input_size, PROT_READ, MAP_PRIVATE, input_fd, 0);
+		if (input == MAP_FAILED) {
+			printf("ERROR: Cannot read file \"%s\"!\n", input_path);
+			close(input_fd);
+			return NULL;
+		}
+		madvise((void*) input, input_size, MADV_SEQUENTIAL);
+	}
+	close(input_fd);
+
+	char error[INPUT_ERROR_MAX];
+	struct process_table* process_table = parse_input(input, input_size, input_path, pool, error);
+	if (process_table == NULL) {
+		printf("ERROR: %s\n", error);
+	}
+
+	if (input != NULL) {
+		munmap((void*) input, input_size);
+	}
+	if (stats != NULL) {
+		stats->bytes = input_size;
+		stats->seconds = current_seconds() - start_seconds;
 	}
-	return process_list;
+	return process_table;
 }
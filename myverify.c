@@ -0,0 +1,789 @@
+/**
+ * Implementation of the self-check of the simulator, which makes sure that changes to the engine, the Ready
+ * states or the input handling leave the schedules unchanged. It compares every policy against the full known
+ * output of the sample input (every line of the output file and the averages, kept in the directory "golden"
+ * together with the sample input), compares SPN and SRT against simple reference implementations written the
+ * way spn() and srt() first were (a sorted list scanned from the front, one event at a time) on many small
+ * random traces full of ties, zero service times and idle gaps, compares streaming the input, the multi-CPU
+ * loop with one CPU and resuming from a checkpoint against simulating a table on the same traces with random
+ * policy parameters, and fails if the throughput of any policy drops below a threshold.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include "mydispatcher.h"
+
+/* The largest number of processes in a random trace; small traces make a difference easy to read. */
+#define VERIFY_MAX_PROCESSES 64
+
+/* The number of processes in the trace the throughput of every policy is measured on. */
+#define VERIFY_BENCH_PROCESSES 1000000
+
+/* The ways of running the same simulation, whose output and averages must all be the same. */
+#define RUN_TABLE 0				// simulate() over a table that holds the whole trace
+#define RUN_STREAMING 1			// simulate() reading the trace from a file only when processes arrive
+#define RUN_SMP 2				// simulate_smp() with one CPU
+#define RUN_RESUMED 3			// simulate() resumed from a checkpoint written partway through another run
+#define NUM_RUN_KINDS 4
+
+/* What each way of running a simulation is called in error statements. */
+static const char* const run_kind_names[NUM_RUN_KINDS] = { "a table", "streaming", "the multi-CPU loop on one CPU", "resuming from a checkpoint" };
+
+/* Representation of the scratch files of a self-check, in a directory of their own. */
+struct verify_files {
+	char directory[64];			// the directory holding the files
+	char input_path[96];		// the trace read when streaming
+	char output_path[96];		// the output file of a simulation
+	char checkpoint_path[96];	// the checkpoint written partway through a simulation
+};
+
+#ifdef ENABLE_METRICS
+/* The number of processes in the input the depth statistics of the Ready state are checked on. */
+#define DEPTH_SIZE 3
+
+/* An input where a long process keeps two short ones waiting, so that the policies arrivals cannot preempt
+ * run the clock past both arrivals. */
+static const long depth_input[DEPTH_SIZE][2] = { { 0, 10 }, { 1, 1 }, { 2, 1 } };
+
+/* Representation of the known depth statistics of the Ready state of a policy for that input. */
+struct known_depth {
+	const char* policy;			// the name of the policy
+	long max_ready_depth;		// the largest number of processes ready at once
+	long ready_depth_time;		// the number of ready processes integrated over time
+	long elapsed_time;			// the simulated time the integral covers
+};
+
+/* The known depth statistics of every policy for that input. */
+static const struct known_depth known_depths[] = {
+	{ "FCFS", 2, 18, 12 }, { "RR", 1, 3, 12 }, { "SPN", 2, 18, 12 },
+	{ "SRT", 1, 2, 12 }, { "HRRN", 2, 18, 12 }, { "MLFQ", 1, 2, 12 }
+};
+#endif
+
+/*
+ * Create a small random trace meant to hit the corner cases of a scheduler: many processes arriving at the
+ * same time, many equal service times, processes with a service time of 0 and gaps in which the CPU is idle.
+ *
+ * state:	a pointer to the state of the random number generator
+ * pool:	a pointer to the memory pool that owns the trace
+ *
+ * Returns: a pointer to the table of processes of the trace
+ */
+static struct process_table* random_trace(uint64_t* state, struct arena* pool) {
+	struct process_table* table = create_process_table(pool);
+	int num_processes = 1 + (int) (next_random(state) % VERIFY_MAX_PROCESSES);
+	long arrival = (long) (next_random(state) % 4);
+	for (int i = 0; i < num_processes; i++) {
+		int gap_kind = (int) (next_random(state) % 20);
+		if (i > 0 && gap_kind >= 8) {
+			arrival += gap_kind < 17 ? 1 + (long) (next_random(state) % 3) : gap_kind < 19 ? 4 + (long) (next_random(state) % 7) : 20 + (long) (next_random(state) % 80);
+		}
+		long service = next_random(state) % 7 == 0 ? 0 : 1 + (long) (next_random(state) % 8);
+		process_table_add(table, arrival, service);
+	}
+	return table;
+}
+
+/*
+ * Choose random parameters for the policies, so that short and long time quanta, one or several levels,
+ * priority boosts and aging are all tried.
+ *
+ * state:	a pointer to the state of the random number generator
+ * params:	a pointer to where the parameters are stored
+ */
+static void random_params(uint64_t* state, struct policy_params* params) {
+	params->quantum = 1 + (long) (next_random(state) % 4);
+	params->num_levels = 1 + (int) (next_random(state) % 4);
+	params->boost_interval = next_random(state) % 2 == 0 ? 0 : 1 + (long) (next_random(state) % 20);
+	params->aging_interval = next_random(state) % 2 == 0 ? 0 : 1 + (long) (next_random(state) % 6);
+}
+
+/*
+ * Add a process to a list of ready processes sorted by remaining time, after those with the same remaining
+ * time, as enqueue_with_sorting() did.
+ *
+ * ready:		the list, with room for one more process
+ * num_ready:	a pointer to the number of processes in the list
+ * remaining:	the remaining times of all processes
+ * process:		the row of the process to add
+ */
+static void reference_enqueue(int* ready, int* num_ready, const long* remaining, int process) {
+	int position = (*num_ready)++;
+	while (position > 0 && remaining[ready[position - 1]] > remaining[process]) {
+		ready[position] = ready[position - 1];
+		position--;
+	}
+	ready[position] = process;
+}
+
+/*
+ * Remove the first process of a list of ready processes.
+ *
+ * ready:		the list
+ * num_ready:	a pointer to the number of processes in the list
+ *
+ * Returns: the row of the removed process
+ */
+static int reference_dequeue(int* ready, int* num_ready) {
+	int process = ready[0];
+	memmove(ready, ready + 1, --(*num_ready) * sizeof(int));
+	return process;
+}
+
+/*
+ * Schedule a trace with SPN the way spn() first did, recording every completion.
+ *
+ * table:		a pointer to the table of processes
+ * expected:	an array with one element per process where the completions are stored in order
+ * pool:		a pointer to the memory pool used for scratch space
+ */
+static void reference_spn(const struct process_table* table, struct process_result* expected, struct arena* pool) {
+	int num_processes = table->size;
+	int* ready = (int*) arena_alloc(pool, num_processes * sizeof(int));
+	int num_ready = 0;
+	int num_completed = 0;
+	int next = 0;
+	long current_time = table->arrival_time[0];
+	int running_process = -1;
+	long start_time = 0;
+	while (1) {
+		if (running_process == -1) {
+			if (next < num_processes && table->arrival_time[next] <= current_time) {
+				reference_enqueue(ready, &num_ready, table->service_time, next++);
+			} else if (num_ready > 0) {
+				running_process = reference_dequeue(ready, &num_ready);
+				start_time = current_time;
+			} else if (next < num_processes) {
+				current_time = table->arrival_time[next];
+			} else {
+				break;
+			}
+		} else {
+			current_time += table->service_time[running_process];
+			struct process_result result = { table->id[running_process], 0, table->arrival_time[running_process], table->service_time[running_process], start_time, current_time };
+			expected[num_completed++] = result;
+			running_process = -1;
+		}
+	}
+}
+
+/*
+ * Schedule a trace with SRT the way srt() first did, recording every completion.
+ *
+ * table:		a pointer to the table of processes
+ * expected:	an array with one element per process where the completions are stored in order
+ * pool:		a pointer to the memory pool used for scratch space
+ */
+static void reference_srt(const struct process_table* table, struct process_result* expected, struct arena* pool) {
+	int num_processes = table->size;
+	int* ready = (int*) arena_alloc(pool, num_processes * sizeof(int));
+	long* remaining = (long*) arena_alloc(pool, num_processes * sizeof(long));
+	memcpy(remaining, table->service_time, num_processes * sizeof(long));
+	int num_ready = 0;
+	int num_completed = 0;
+	int next = 0;
+	long current_time = table->arrival_time[0];
+	int running_process = -1;
+	long start_time = 0;
+	while (1) {
+		if (next < num_processes && table->arrival_time[next] == current_time) {
+			reference_enqueue(ready, &num_ready, remaining, next++);
+		} else if (running_process == -1) {
+			if (num_ready > 0) {
+				running_process = reference_dequeue(ready, &num_ready);
+				start_time = current_time;
+			} else if (next < num_processes) {
+				current_time = table->arrival_time[next];
+			} else {
+				break;
+			}
+		} else if (remaining[running_process] == 0) {
+			struct process_result result = { table->id[running_process], 0, table->arrival_time[running_process], table->service_time[running_process], start_time, current_time };
+			expected[num_completed++] = result;
+			running_process = -1;
+		} else if (num_ready > 0 && remaining[ready[0]] < remaining[running_process]) {
+			reference_enqueue(ready, &num_ready, remaining, running_process);
+			running_process = reference_dequeue(ready, &num_ready);
+			start_time = current_time;
+		} else if (next < num_processes && table->arrival_time[next] - current_time <= remaining[running_process]) {
+			remaining[running_process] -= table->arrival_time[next] - current_time;
+			current_time = table->arrival_time[next];
+		} else {
+			current_time += remaining[running_process];
+			remaining[running_process] = 0;
+		}
+	}
+}
+
+/*
+ * Create a directory for the scratch files of a self-check.
+ *
+ * files:	a pointer to where the paths of the files are stored
+ *
+ * Returns: 0 on success, -1 if the directory cannot be created
+ */
+static int create_verify_files(struct verify_files* files) {
+	const char* temporary_directory = getenv("TMPDIR") != NULL && strlen(getenv("TMPDIR")) < 32 ? getenv("TMPDIR") : "/tmp";
+	snprintf(files->directory, sizeof(files->directory), "%s/mydispatcher_XXXXXX", temporary_directory);
+	if (mkdtemp(files->directory) == NULL) {
+		return -1;
+	}
+	snprintf(files->input_path, sizeof(files->input_path), "%s/input.dat", files->directory);
+	snprintf(files->output_path, sizeof(files->output_path), "%s/output.dat", files->directory);
+	snprintf(files->checkpoint_path, sizeof(files->checkpoint_path), "%s/checkpoint", files->directory);
+	return 0;
+}
+
+/*
+ * Remove the scratch files of a self-check and their directory.
+ *
+ * files:	a pointer to the paths of the files
+ */
+static void remove_verify_files(const struct verify_files* files) {
+	char temporary_path[128];
+	snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", files->checkpoint_path);
+	unlink(files->input_path);
+	unlink(files->output_path);
+	unlink(files->checkpoint_path);
+	unlink(temporary_path);
+	rmdir(files->directory);
+}
+
+/*
+ * Write a table of processes to a file in the input format.
+ *
+ * table:	a pointer to the table of processes
+ * path:	the path of the file to write
+ *
+ * Returns: 0 on success, -1 if the file cannot be written
+ */
+static int write_trace(const struct process_table* table, const char* path) {
+	FILE* trace_file = fopen(path, "w");
+	if (trace_file == NULL) {
+		return -1;
+	}
+	for (int i = 0; i < table->size; i++) {
+		fprintf(trace_file, "%ld %ld\n", table->arrival_time[i], table->service_time[i]);
+	}
+	return fclose(trace_file) != 0 ? -1 : 0;
+}
+
+/*
+ * Read a whole text file into memory.
+ *
+ * path:	the path of the file
+ * pool:	a pointer to the memory pool the text is taken from
+ *
+ * Returns: the text, ending with a null character, or NULL if the file cannot be read
+ */
+static char* read_text_file(const char* path, struct arena* pool) {
+	FILE* text_file = fopen(path, "rb");
+	if (text_file == NULL) {
+		return NULL;
+	}
+	fseek(text_file, 0, SEEK_END);
+	long size = ftell(text_file);
+	rewind(text_file);
+	char* text = (char*) arena_alloc(pool, size + 1);
+	size_t num_read = fread(text, 1, size, text_file);
+	fclose(text_file);
+	text[num_read] = '\0';
+	return text;
+}
+
+/*
+ * Remove the CPU number from every line of an output written by the multi-CPU loop on one CPU, so that it
+ * reads as the output of simulate().
+ *
+ * text:	the output, which is changed in place
+ */
+static void remove_cpu_numbers(char* text) {
+	const char marker[] = " on CPU 0";
+	char* write_position = text;
+	for (const char* read_position = text; *read_position != '\0';) {
+		if (strncmp(read_position, marker, sizeof(marker) - 1) == 0) {
+			read_position += sizeof(marker) - 1;
+		} else {
+			*write_position++ = *read_position++;
+		}
+	}
+	*write_position = '\0';
+}
+
+/*
+ * Simulate a policy over a trace in one of the ways a simulation can be run, writing the output file of the
+ * files of the self-check. To resume from a checkpoint, a first simulation writes a checkpoint after a
+ * specified number of steps, and a second one carries on from it, cutting the output back to where it was.
+ *
+ * kind:			how to run the simulation (RUN_TABLE, RUN_STREAMING, RUN_SMP or RUN_RESUMED)
+ * policy:			a pointer to the scheduling policy
+ * params:			a pointer to the parameters of the policy
+ * table:			a pointer to the table of processes, which is not changed (and has been written to the
+ *					input file of the self-check for RUN_STREAMING)
+ * checkpoint_step:	the step after which the checkpoint is written (RUN_RESUMED only)
+ * files:			a pointer to the paths of the files of the self-check
+ * pool:			a pointer to the memory pool of the simulation
+ * results:			a pointer to where the totals needed for the averages are stored
+ *
+ * Returns: 0 on success, -1 if a file cannot be read or written
+ */
+static int simulate_to_file(int kind, const struct policy* policy, const struct policy_params* params, const struct process_table* table, int checkpoint_step, const struct verify_files* files, struct arena* pool, struct sim_results* results) {
+	results->latency = NULL;
+	results->checkpoint = NULL;
+	results->what_if = NULL;
+	struct output_writer* output = open_output_writer(files->output_path, OUTPUT_TEXT, 0, pool);
+	if (output == NULL) {
+		return -1;
+	}
+	struct arrival_stream arrivals;
+	struct input_reader* reader = NULL;
+	if (kind == RUN_STREAMING) {
+		reader = open_input_reader(files->input_path, pool);
+		if (reader == NULL) {
+			close_output_writer(output);
+			return -1;
+		}
+		init_reader_stream(&arrivals, create_process_table(pool), reader);
+	} else {
+		init_table_stream(&arrivals, copy_process_table(table, pool));
+	}
+
+	if (kind == RUN_SMP) {
+		struct smp_results smp_results;
+		simulate_smp(policy, params, 1, QUEUE_GLOBAL, &arrivals, output, pool, results, &smp_results);
+	} else {
+		if (kind == RUN_RESUMED) {
+			/* Make the first checkpoint due at the chosen step, and the next one never. */
+			results->checkpoint = create_checkpointer(files->checkpoint_path, 1e9, pool);
+			results->checkpoint->next_seconds = 0;
+			results->checkpoint->steps = CHECKPOINT_CHECK_STEPS - checkpoint_step;
+		}
+		simulate(policy, params, &arrivals, output, pool, results);
+	}
+	int error = close_output_writer(output) != 0 || (reader != NULL && reader->error) || (results->checkpoint != NULL && results->checkpoint->error);
+	if (reader != NULL) {
+		close_input_reader(reader);
+	}
+	if (error || kind != RUN_RESUMED || results->checkpoint->num_written == 0) {
+		/* A simulation that ended before the chosen step has nothing to resume. */
+		return error ? -1 : 0;
+	}
+
+	struct checkpointer* resume = create_checkpointer(NULL, 0, pool);
+	if (open_checkpoint(resume, files->checkpoint_path, policy, params, OUTPUT_TEXT) != 0) {
+		return -1;
+	}
+	output = reopen_output_writer(files->output_path, OUTPUT_TEXT, 0, resume->output_size, pool);
+	if (output == NULL) {
+		close_checkpointer(resume);
+		return -1;
+	}
+	init_table_stream(&arrivals, copy_process_table(table, pool));
+	results->checkpoint = resume;
+	simulate(policy, params, &arrivals, output, pool, results);
+	close_checkpointer(resume);
+	return close_output_writer(output) != 0 || resume->error ? -1 : 0;
+}
+
+/*
+ * Simulate a policy over a trace in one of the ways a simulation can be run, and get the full text of the
+ * result: every line of the output file, followed by the averages as print_averages() prints them out.
+ *
+ * kind:			how to run the simulation (RUN_TABLE, RUN_STREAMING, RUN_SMP or RUN_RESUMED)
+ * policy:			a pointer to the scheduling policy
+ * params:			a pointer to the parameters of the policy
+ * table:			a pointer to the table of processes, which is not changed
+ * checkpoint_step:	the step after which the checkpoint is written (RUN_RESUMED only)
+ * files:			a pointer to the paths of the files of the self-check
+ * pool:			a pointer to the memory pool of the simulation
+ *
+ * Returns: the text, or NULL if a file cannot be read or written (an error statement is printed out in that
+ *			case)
+ */
+static char* simulate_to_text(int kind, const struct policy* policy, const struct policy_params* params, const struct process_table* table, int checkpoint_step, const struct verify_files* files, struct arena* pool) {
+	struct sim_results results;
+	FILE* output_file = NULL;
+	if (simulate_to_file(kind, policy, params, table, checkpoint_step, files, pool, &results) != 0 || (output_file = fopen(files->output_path, "a")) == NULL) {
+		printf("ERROR: Cannot use the scratch files in \"%s\"!\n", files->directory);
+		return NULL;
+	}
+	write_averages(output_file, &results);
+	fclose(output_file);
+	char* text = read_text_file(files->output_path, pool);
+	if (text != NULL && kind == RUN_SMP) {
+		remove_cpu_numbers(text);
+	}
+	return text;
+}
+
+/*
+ * Simulate a policy over a table of processes, keeping the result of every process in order of completion.
+ *
+ * policy:	a pointer to the scheduling policy
+ * params:	a pointer to the parameters of the policy
+ * table:	a pointer to the table of processes, which is not changed
+ * pool:	a pointer to the memory pool of the simulation
+ *
+ * Returns: a pointer to the output writer holding the results, which the caller closes
+ */
+static struct output_writer* simulate_to_records(const struct policy* policy, const struct policy_params* params, const struct process_table* table, struct arena* pool) {
+	struct output_writer* output = open_output_writer(NULL, OUTPUT_RECORDS, 0, pool);
+	struct arrival_stream arrivals;
+	init_table_stream(&arrivals, copy_process_table(table, pool));
+	struct sim_results results;
+	results.latency = NULL;
+	results.checkpoint = NULL;
+	results.what_if = NULL;
+	simulate(policy, params, &arrivals, output, pool, &results);
+	return output;
+}
+
+/*
+ * Print out a schedule that differs from the expected one, together with the trace, so that the difference
+ * can be reproduced by hand.
+ *
+ * table:			a pointer to the table of processes
+ * output:			a pointer to the output writer holding the actual schedule
+ * expected:		the expected completions, in order
+ * num_expected:	the number of expected completions
+ */
+static void print_difference(const struct process_table* table, const struct output_writer* output, const struct process_result* expected, int num_expected) {
+	printf("Input (arrival time, service time):\n");
+	for (int i = 0; i < table->size; i++) {
+		printf("%ld %ld\n", table->arrival_time[i], table->service_time[i]);
+	}
+	printf("%-28s %s\n", "Expected (ID: start-finish)", "Actual");
+	for (int i = 0; i < num_expected || i < output->num_records; i++) {
+		char expected_text[64] = "-";
+		char actual_text[64] = "-";
+		if (i < num_expected) {
+			snprintf(expected_text, sizeof(expected_text), "%d: %ld-%ld", expected[i].id, expected[i].start_time, expected[i].finish_time);
+		}
+		if (i < output->num_records) {
+			snprintf(actual_text, sizeof(actual_text), "%d: %ld-%ld", output->records[i].id, output->records[i].start_time, output->records[i].finish_time);
+		}
+		printf("%-28s %s\n", expected_text, actual_text);
+	}
+}
+
+/*
+ * Check whether a schedule has the expected completions, comparing the ID, the start of the last run and the
+ * finish time of every process in order of completion.
+ *
+ * output:			a pointer to the output writer holding the schedule
+ * expected:		the expected completions, in order
+ * num_expected:	the number of expected completions
+ *
+ * Returns: 1 if the schedule is as expected, 0 otherwise
+ */
+static int same_schedule(const struct output_writer* output, const struct process_result* expected, int num_expected) {
+	if (output->num_records != num_expected) {
+		return 0;
+	}
+	for (int i = 0; i < num_expected; i++) {
+		if (output->records[i].id != expected[i].id || output->records[i].start_time != expected[i].start_time || output->records[i].finish_time != expected[i].finish_time) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*
+ * Print out the input of a simulation, its parameters and two texts of its result that differ.
+ *
+ * table:			a pointer to the table of processes
+ * params:			a pointer to the parameters of the policy
+ * expected_name:	what the first text is called
+ * expected:		the first text
+ * actual_name:		what the second text is called
+ * actual:			the second text
+ */
+static void print_text_difference(const struct process_table* table, const struct policy_params* params, const char* expected_name, const char* expected, const char* actual_name, const char* actual) {
+	printf("Input (arrival time, service time):\n");
+	for (int i = 0; i < table->size; i++) {
+		printf("%ld %ld\n", table->arrival_time[i], table->service_time[i]);
+	}
+	printf("Parameters: quantum %ld, levels %d, boost %ld, aging %ld\n", params->quantum, params->num_levels, params->boost_interval, params->aging_interval);
+	printf("%s:\n%s%s:\n%s", expected_name, expected, actual_name, actual);
+}
+
+/*
+ * Compare every policy against its known output for the sample input, line by line: the runs that ended in
+ * a completion or a preemption, and the averages. The sample input is the file "input.dat" of the directory
+ * of known outputs, and the known output of each policy is the file named after it, such as "SRT.txt", which
+ * "make check" also compares the output of the program against.
+ *
+ * spec:	a pointer to the description of the check, which holds the directory of known outputs
+ * params:	a pointer to the default parameters of the policies
+ * files:	a pointer to the paths of the files of the self-check
+ * pool:	a pointer to the memory pool used for the simulations
+ * error:	a pointer to where 1 is stored if a file cannot be read or written, so that not every policy could be
+ *			checked (an error statement is printed out in that case)
+ *
+ * Returns: the number of policies whose output differs
+ */
+static int check_golden_outputs(const struct verify_spec* spec, const struct policy_params* params, const struct verify_files* files, struct arena* pool, int* error) {
+	const char* const names[] = { "FCFS", "RR", "SPN", "SRT", "HRRN", "MLFQ" };
+	char path[1024];
+	int num_failed = 0;
+	for (int i = 0; i < 6; i++) {
+		reset_arena(pool);
+		snprintf(path, sizeof(path), "%s/input.dat", spec->golden_dir);
+		struct process_table* table = read_input(path, pool, NULL);
+		if (table == NULL) {
+			*error = 1;
+			return num_failed;
+		}
+		snprintf(path, sizeof(path), "%s/%s.txt", spec->golden_dir, names[i]);
+		char* expected = read_text_file(path, pool);
+		if (expected == NULL) {
+			printf("ERROR: Cannot open file \"%s\"!\n", path);
+			*error = 1;
+			return num_failed;
+		}
+		char* text = simulate_to_text(RUN_TABLE, find_policy(names[i]), params, table, 0, files, pool);
+		if (text == NULL) {
+			*error = 1;
+			return num_failed;
+		}
+		if (strcmp(text, expected) != 0) {
+			printf("ERROR: %s does not give its known output in \"%s\" for the sample input!\n", names[i], path);
+			print_text_difference(table, params, "Expected", expected, "Actual", text);
+			num_failed++;
+		}
+	}
+	return num_failed;
+}
+
+#ifdef ENABLE_METRICS
+/*
+ * Compare the depth statistics of the Ready state of every policy against the known ones for a short input.
+ *
+ * params:	a pointer to the default parameters of the policies
+ * pool:	a pointer to the memory pool used for the simulations
+ *
+ * Returns: the number of policies whose statistics differ
+ */
+static int check_ready_depths(const struct policy_params* params, struct arena* pool) {
+	int num_failed = 0;
+	for (size_t i = 0; i < sizeof(known_depths) / sizeof(known_depths[0]); i++) {
+		reset_arena(pool);
+		struct process_table* table = create_process_table(pool);
+		for (int j = 0; j < DEPTH_SIZE; j++) {
+			process_table_add(table, depth_input[j][0], depth_input[j][1]);
+		}
+		reset_metrics();
+		close_output_writer(simulate_to_records(find_policy(known_depths[i].policy), params, table, pool));
+		if (current_metrics.max_ready_depth != known_depths[i].max_ready_depth || current_metrics.ready_depth_time != known_depths[i].ready_depth_time || current_metrics.elapsed_time != known_depths[i].elapsed_time) {
+			printf("ERROR: %s does not give its known Ready depth! Expected: max %ld, %ld over %ld. Actual: max %ld, %.0f over %ld.\n", known_depths[i].policy, known_depths[i].max_ready_depth, known_depths[i].ready_depth_time, known_depths[i].elapsed_time, current_metrics.max_ready_depth, current_metrics.ready_depth_time, current_metrics.elapsed_time);
+			num_failed++;
+		}
+	}
+	reset_metrics();
+	return num_failed;
+}
+#endif
+
+/*
+ * Compare SPN and SRT against their reference implementations on random traces. The first trace that
+ * differs is printed out for each policy.
+ *
+ * spec:	a pointer to the description of the check
+ * params:	a pointer to the default parameters of the policies
+ * pool:	a pointer to the memory pool used for the simulations
+ *
+ * Returns: the number of traces on which some policy differs
+ */
+static int check_random_traces(const struct verify_spec* spec, const struct policy_params* params, struct arena* pool) {
+	const struct policy* policies[] = { &spn_policy, &srt_policy };
+	void (*references[])(const struct process_table*, struct process_result*, struct arena*) = { reference_spn, reference_srt };
+	int printed[] = { 0, 0 };
+	int num_failed = 0;
+	uint64_t state = spec->seed;
+	for (int i = 0; i < spec->num_traces; i++) {
+		reset_arena(pool);
+		struct process_table* table = random_trace(&state, pool);
+		struct process_result* expected = (struct process_result*) arena_alloc(pool, table->size * sizeof(struct process_result));
+		int failed = 0;
+		for (int j = 0; j < 2; j++) {
+			references[j](table, expected, pool);
+			struct output_writer* output = simulate_to_records(policies[j], params, table, pool);
+			if (!same_schedule(output, expected, table->size)) {
+				failed = 1;
+				if (!printed[j]) {
+					printf("ERROR: %s differs from its reference on random trace %d!\n", policies[j]->name, i + 1);
+					print_difference(table, output, expected, table->size);
+					printed[j] = 1;
+				}
+			}
+			close_output_writer(output);
+		}
+		num_failed += failed;
+	}
+	return num_failed;
+}
+
+/*
+ * Compare every way of running a simulation against simulating a table that holds the whole trace, for every
+ * policy on random traces with random parameters: streaming the trace from a file, the multi-CPU loop on one
+ * CPU and resuming from a checkpoint written at a random step. The output and the averages must be the same.
+ * The first trace that differs is printed out for each way.
+ *
+ * spec:	a pointer to the description of the check
+ * files:	a pointer to the paths of the files of the self-check
+ * pool:	a pointer to the memory pool used for the simulations
+ * error:	a pointer to where 1 is stored if the scratch files cannot be used, so that not every trace could be
+ *			checked (an error statement is printed out in that case)
+ *
+ * Returns: the number of traces on which some way differs
+ */
+static int check_equivalent_runs(const struct verify_spec* spec, const struct verify_files* files, struct arena* pool, int* error) {
+	const char* const names[] = { "FCFS", "RR", "SPN", "SRT", "HRRN", "MLFQ" };
+	int printed[NUM_RUN_KINDS] = { 0 };
+	int num_failed = 0;
+	uint64_t state = spec->seed;
+	for (int i = 0; i < spec->num_traces; i++) {
+		reset_arena(pool);
+		struct process_table* table = random_trace(&state, pool);
+		struct policy_params params;
+		random_params(&state, &params);
+		if (write_trace(table, files->input_path) != 0) {
+			printf("ERROR: Cannot use the scratch files in \"%s\"!\n", files->directory);
+			*error = 1;
+			return num_failed;
+		}
+		int failed = 0;
+		for (int j = 0; j < 6; j++) {
+			const struct policy* policy = find_policy(names[j]);
+			char* expected = simulate_to_text(RUN_TABLE, policy, &params, table, 0, files, pool);
+			for (int kind = RUN_TABLE + 1; expected != NULL && kind < NUM_RUN_KINDS; kind++) {
+				int checkpoint_step = 1 + (int) (next_random(&state) % (4 * table->size + 4));
+				char* actual = simulate_to_text(kind, policy, &params, table, checkpoint_step, files, pool);
+				if (actual == NULL) {
+					*error = 1;
+					return num_failed;
+				}
+				if (strcmp(expected, actual) != 0) {
+					failed = 1;
+					if (!printed[kind]) {
+						printf("ERROR: %s gives another output with %s than over a table on random trace %d!\n", policy->name, run_kind_names[kind], i + 1);
+						print_text_difference(table, &params, "Over a table", expected, "With the other way", actual);
+						printed[kind] = 1;
+					}
+				}
+			}
+			if (expected == NULL) {
+				*error = 1;
+				return num_failed;
+			}
+		}
+		num_failed += failed;
+	}
+	return num_failed;
+}
+
+/*
+ * Measure the throughput of every policy on a large random trace, in events (completions and preemptions)
+ * per second of scheduling.
+ *
+ * spec:	a pointer to the description of the check, which holds the smallest throughput allowed
+ * params:	a pointer to the default parameters of the policies
+ * pool:	a pointer to the memory pool used for the simulations
+ *
+ * Returns: the number of policies slower than allowed
+ */
+static int check_throughput(const struct verify_spec* spec, const struct policy_params* params, struct arena* pool) {
+	const char* const names[] = { "FCFS", "RR", "SPN", "SRT", "HRRN", "MLFQ" };
+	reset_arena(pool);
+	struct process_table* table = create_process_table(pool);
+	uint64_t state = spec->seed;
+	long arrival = 0;
+	for (int i = 0; i < VERIFY_BENCH_PROCESSES; i++) {
+		arrival += (long) (next_random(&state) % 8);
+		process_table_add(table, arrival, 1 + (long) (next_random(&state) % 5));
+	}
+
+	int num_failed = 0;
+	struct arena* run_pool = create_arena();
+	for (int i = 0; i < 6; i++) {
+		reset_arena(run_pool);
+		const struct policy* policy = find_policy(names[i]);
+		struct output_writer* output = open_output_writer(NULL, OUTPUT_NONE, 0, run_pool);
+		struct arrival_stream arrivals;
+		init_table_stream(&arrivals, copy_process_table(table, run_pool));
+		struct sim_results results;
+		results.latency = NULL;
+		results.checkpoint = NULL;
+		results.what_if = NULL;
+		double start_seconds = current_seconds();
+		simulate(policy, params, &arrivals, output, run_pool, &results);
+		double seconds = current_seconds() - start_seconds;
+		close_output_writer(output);
+		double rate = seconds > 0 ? results.num_events / seconds : 0;
+		printf("%-5s %d processes: %12.0f events/s\n", policy->name, VERIFY_BENCH_PROCESSES, rate);
+		if (seconds > 0 && rate < spec->min_rate) {
+			printf("ERROR: %s is slower than %.0f events/s!\n", policy->name, spec->min_rate);
+			num_failed++;
+		}
+	}
+	destroy_arena(run_pool);
+	return num_failed;
+}
+
+/*
+ * Check that the simulator gives the schedules it should: every policy against its known output for the
+ * sample input, then (in builds with the counters) against its known depth statistics of the Ready state for a
+ * short input, then SPN and SRT against their reference implementations on random traces, then every way of
+ * running a simulation against the others on random traces, and, if a smallest throughput is given, the
+ * throughput of every policy. An error statement is printed out for every check that fails.
+ *
+ * spec:	a pointer to the description of the check
+ *
+ * Returns: 0 if every check passes, 1 otherwise
+ */
+int run_verification(const struct verify_spec* spec) {
+	struct verify_files files;
+	if (create_verify_files(&files) != 0) {
+		printf("ERROR: Cannot create a directory for the scratch files!\n");
+		return 1;
+	}
+	struct policy_params params;
+	default_policy_params(&params);
+	struct arena* pool = create_arena();
+
+	int golden_error = 0;
+	int golden_failed = check_golden_outputs(spec, &params, &files, pool, &golden_error);
+	if (golden_error) {
+		printf("Could not check every policy against its known output for the sample input in \"%s\"\n", spec->golden_dir);
+	} else {
+		printf("Checked 6 policies against their known output for the sample input: %d failed\n", golden_failed);
+	}
+	int depth_failed = 0;
+#ifdef ENABLE_METRICS
+	depth_failed = check_ready_depths(&params, pool);
+	printf("Checked %d policies against their known Ready depths for a short input: %d failed\n", (int) (sizeof(known_depths) / sizeof(known_depths[0])), depth_failed);
+#endif
+	int random_failed = check_random_traces(spec, &params, pool);
+	printf("Checked SPN and SRT against their references on %d random traces (seed %lu): %d failed\n", spec->num_traces, spec->seed, random_failed);
+	int equivalence_error = 0;
+	int equivalence_failed = check_equivalent_runs(spec, &files, pool, &equivalence_error);
+	if (equivalence_error) {
+		printf("Could not check streaming, one CPU of the multi-CPU loop and resuming from checkpoints against simulating a table on every random trace\n");
+	} else {
+		printf("Checked streaming, one CPU of the multi-CPU loop and resuming from checkpoints against simulating a table for every policy on %d random traces with random parameters: %d failed\n", spec->num_traces, equivalence_failed);
+	}
+	int throughput_failed = 0;
+	if (spec->min_rate > 0) {
+		throughput_failed = check_throughput(spec, &params, pool);
+	}
+
+	destroy_arena(pool);
+	remove_verify_files(&files);
+	return golden_error || golden_failed != 0 || depth_failed != 0 || random_failed != 0 || equivalence_error || equivalence_failed != 0 || throughput_failed != 0;
+}
@@ -0,0 +1,498 @@
+/**
+ * Implementation of what-if analyses, which answer questions such as "what if process 4 took 2 time units
+ * instead of 5" or "what if this process arrived 10 time units later" without simulating the whole input
+ * again. The policy is simulated over the input once, keeping snapshots of the simulation in memory. A query
+ * edits some processes, resumes from the last snapshot taken before the first edited process, and simulates
+ * only until the schedule becomes the same as the original one again. That happens at the first time after
+ * the edited processes that the CPU is idle in both schedules: how much work is left at any time does not
+ * depend on the policy, and once both schedules have finished everything that arrived before the same
+ * process, everything after it happens the same way. The results of the processes from there on are taken
+ * from the original simulation.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include <string.h>
+#include "mydispatcher.h"
+
+/* The fields of a process a what-if query can edit. */
+#define EDIT_SERVICE 0
+#define EDIT_ARRIVAL 1
+
+/* Representation of one edit of a what-if query, such as "4:service=2". */
+struct what_if_edit {
+	long id;						// the ID of the process to edit
+	int field;						// EDIT_SERVICE or EDIT_ARRIVAL
+	long value;						// the new service time or arrival time
+};
+
+/*
+ * Create a copy of a process table with columns of its own, all of which can be changed.
+ *
+ * table:	a pointer to the table to copy
+ * pool:	a pointer to the memory pool that owns the copy
+ *
+ * Returns: a pointer to the copy
+ */
+static struct process_table* clone_process_table(const struct process_table* table, struct arena* pool) {
+	struct process_table* clone = (struct process_table*) arena_alloc(pool, sizeof(struct process_table));
+	int capacity = table->size > 0 ? table->size : 1;
+	clone->id = (int*) arena_alloc(pool, capacity * sizeof(int));
+	clone->arrival_time = (long*) arena_alloc(pool, capacity * sizeof(long));
+	clone->service_time = (long*) arena_alloc(pool, capacity * sizeof(long));
+	clone->remaining_time = (long*) arena_alloc(pool, capacity * sizeof(long));
+	clone->free_slots = NULL;
+	clone->num_free = 0;
+	clone->size = table->size;
+	clone->capacity = capacity;
+	clone->pool = pool;
+	memcpy(clone->id, table->id, table->size * sizeof(int));
+	memcpy(clone->arrival_time, table->arrival_time, table->size * sizeof(long));
+	memcpy(clone->service_time, table->service_time, table->size * sizeof(long));
+	memcpy(clone->remaining_time, table->service_time, table->size * sizeof(long));
+	return clone;
+}
+
+/*
+ * Simulate a scheduling policy over a table of processes, keeping snapshots of the simulation and the results
+ * of every process, so that what-if queries about the table can be answered afterwards.
+ *
+ * policy:	a pointer to the scheduling policy
+ * params:	a pointer to the parameters of the policy
+ * table:	a pointer to the table of processes, which must not change while the analysis is used
+ *
+ * Returns: a pointer to the analysis
+ */
+struct what_if* create_what_if(const struct policy* policy, const struct policy_params* params, const struct process_table* table) {
+	struct arena* pool = create_arena();
+	struct what_if* what_if = (struct what_if*) arena_alloc(pool, sizeof(struct what_if));
+	memset(what_if, 0, sizeof(struct what_if));
+	what_if->policy = policy;
+	what_if->params = params;
+	what_if->original = table;
+	what_if->table = clone_process_table(table, pool);
+	what_if->pool = pool;
+	what_if->run_pool = create_arena();
+	int num_processes = table->size;
+
+	/* Whether the CPU is idle right before a process arrives does not depend on the policy, so it is worked
+	 * out from the table alone: the CPU is busy until all work that has arrived is done. The first process
+	 * never counts, since the simulation starts at its arrival. */
+	what_if->idle_before = (char*) arena_alloc(pool, num_processes + 1);
+	long busy_until = num_processes > 0 ? table->arrival_time[0] : 0;
+	for (int i = 0; i < num_processes; i++) {
+		what_if->idle_before[i] = i > 0 && table->arrival_time[i] > busy_until;
+		busy_until = (table->arrival_time[i] > busy_until ? table->arrival_time[i] : busy_until) + table->service_time[i];
+	}
+
+	/* Simulate the original schedule, keeping the result of every process and a snapshot every so often. */
+	struct arena* run_pool = what_if->run_pool;
+	struct output_writer* output = open_output_writer(NULL, OUTPUT_RECORDS, 0, run_pool);
+	struct arrival_stream arrivals;
+	init_table_stream(&arrivals, copy_process_table(table, run_pool));
+	struct sim_results* results = &what_if->original_results;
+	results->latency = NULL;
+	results->checkpoint = NULL;
+	results->what_if = what_if;
+	what_if->recording = 1;
+	what_if->steps_left = WHAT_IF_SNAPSHOT_STEPS;
+	simulate(policy, params, &arrivals, output, run_pool, results);
+	what_if->recording = 0;
+	results->what_if = NULL;
+
+	/* Total the results of the processes from every row on, so that a query that stops early can take the
+	 * rest from the original simulation. */
+	long* turnaround = (long*) arena_alloc(run_pool, (num_processes > 0 ? num_processes : 1) * sizeof(long));
+	for (int i = 0; i < output->num_records; i++) {
+		turnaround[output->records[i].id - 1] = output->records[i].finish_time - output->records[i].arrival_time;
+	}
+	size_t suffix_size = (num_processes + 1) * sizeof(struct compensated_sum);
+	what_if->suffix_turnaround = (struct compensated_sum*) arena_alloc(pool, suffix_size);
+	what_if->suffix_normalized_turnaround = (struct compensated_sum*) arena_alloc(pool, suffix_size);
+	what_if->suffix_waiting = (struct compensated_sum*) arena_alloc(pool, suffix_size);
+	memset(&what_if->suffix_turnaround[num_processes], 0, sizeof(struct compensated_sum));
+	memset(&what_if->suffix_normalized_turnaround[num_processes], 0, sizeof(struct compensated_sum));
+	memset(&what_if->suffix_waiting[num_processes], 0, sizeof(struct compensated_sum));
+	for (int i = num_processes - 1; i >= 0; i--) {
+		what_if->suffix_turnaround[i] = what_if->suffix_turnaround[i + 1];
+		what_if->suffix_normalized_turnaround[i] = what_if->suffix_normalized_turnaround[i + 1];
+		what_if->suffix_waiting[i] = what_if->suffix_waiting[i + 1];
+		add_to_sum(&what_if->suffix_turnaround[i], turnaround[i]);
+		add_to_sum(&what_if->suffix_normalized_turnaround[i], ((double) turnaround[i]) / table->service_time[i]);
+		add_to_sum(&what_if->suffix_waiting[i], turnaround[i] - table->service_time[i]);
+	}
+	close_output_writer(output);
+	reset_arena(run_pool);
+	return what_if;
+}
+
+/*
+ * Take a snapshot of the original simulation of a what-if analysis, holding the state of the simulation loop
+ * as write_sim_state() writes it. The next snapshot is due after WHAT_IF_SNAPSHOT_STEPS steps, plus one step
+ * for every 16 bytes of this snapshot, so that all snapshots together take about 16 bytes per step at most.
+ * If the snapshot cannot be kept, it is skipped.
+ *
+ * what_if:		a pointer to the analysis
+ * policy:		a pointer to the scheduling policy
+ * ready:		a pointer to the Ready state of the policy
+ * arrivals:	a pointer to the stream of arriving processes
+ * snapshot:	a pointer to the state of the simulation loop
+ * results:		a pointer to the running totals
+ */
+void take_what_if_snapshot(struct what_if* what_if, const struct policy* policy, void* ready, const struct arrival_stream* arrivals, const struct sim_snapshot* snapshot, const struct sim_results* results) {
+	/* Move past the processes that have completed since the last snapshot, which is only ever done once per
+	 * row, so that a snapshot only looks at the rows that may still be alive. */
+	const struct process_table* table = arrivals->table;
+	while (what_if->first_row < arrivals->next && table->remaining_time[what_if->first_row] == 0 && what_if->first_row != snapshot->running_process) {
+		what_if->first_row++;
+	}
+	what_if->steps_left = WHAT_IF_SNAPSHOT_STEPS;
+
+	if (what_if->num_snapshots == what_if->snapshot_capacity) {
+		int new_capacity = what_if->snapshot_capacity > 0 ? 2 * what_if->snapshot_capacity : 64;
+		what_if->snapshots = (struct what_if_snapshot*) arena_grow(what_if->pool, what_if->snapshots, what_if->snapshot_capacity * sizeof(struct what_if_snapshot), new_capacity * sizeof(struct what_if_snapshot));
+		what_if->snapshot_capacity = new_capacity;
+	}
+	struct what_if_snapshot* taken = &what_if->snapshots[what_if->num_snapshots];
+	FILE* state_file = open_memstream(&taken->state, &taken->state_size);
+	if (state_file == NULL) {
+		return;
+	}
+	write_sim_state(state_file, policy, ready, arrivals, snapshot, results, what_if->first_row);
+	int write_error = ferror(state_file);
+	write_error |= fclose(state_file) != 0;
+	if (write_error) {
+		free(taken->state);
+		return;
+	}
+	taken->current_time = snapshot->current_time;
+	taken->next_arrival = arrivals->next;
+	taken->first_row = what_if->first_row;
+	what_if->num_snapshots++;
+	what_if->steps_left += taken->state_size / 16;
+}
+
+/*
+ * Restore the snapshot a what-if re-simulation resumes from into the simulation, which has just started.
+ *
+ * what_if:		a pointer to the analysis, whose resume field is the snapshot
+ * policy:		a pointer to the scheduling policy
+ * ready:		a pointer to the (empty) Ready state of the policy
+ * arrivals:	a pointer to the stream of arriving processes
+ * snapshot:	a pointer to where the state of the simulation loop is stored
+ * results:		a pointer to where the running totals are stored
+ *
+ * Returns: 0 on success, -1 if the snapshot cannot be read
+ */
+int resume_what_if(struct what_if* what_if, const struct policy* policy, void* ready, struct arrival_stream* arrivals, struct sim_snapshot* snapshot, struct sim_results* results) {
+	FILE* state_file = fmemopen(what_if->resume->state, what_if->resume->state_size, "rb");
+	if (state_file == NULL) {
+		what_if->error = 1;
+		return -1;
+	}
+	int result = read_sim_state(state_file, policy, ready, arrivals, snapshot, results);
+	fclose(state_file);
+	what_if->error = result != 0;
+	what_if->num_resumed = results->num_processes;
+	return result;
+}
+
+/*
+ * Check whether a what-if re-simulation, which has just gone idle before a process arrives, can stop: that is
+ * the case if that process and all processes after it are the same as in the original table, and the CPU was
+ * idle right before it arrived in the original simulation as well.
+ *
+ * what_if:		a pointer to the analysis
+ * next_row:	the row of the process that arrives next
+ * now:			the current time
+ *
+ * Returns: 1 if the re-simulation can stop, 0 otherwise
+ */
+int what_if_converged(struct what_if* what_if, int next_row, long now) {
+	if (!what_if->stop_early || next_row <= what_if->last_edited_row || !what_if->idle_before[next_row]) {
+		return 0;
+	}
+	what_if->stopped_row = next_row;
+	what_if->stopped_time = now;
+	return 1;
+}
+
+/*
+ * Read a non-negative integer at a specified position of a what-if query.
+ *
+ * cursor:	a pointer to the position to read from, which is moved past the integer
+ * value:	a pointer to where the integer is stored
+ *
+ * Returns: 1 if an integer that fits in a long was read, 0 otherwise
+ */
+static int scan_query_integer(const char** cursor, long* value) {
+	const char* current = *cursor;
+	long result = 0;
+	if (*current < '0' || *current > '9') {
+		return 0;
+	}
+	while (*current >= '0' && *current <= '9') {
+		int digit = *current - '0';
+		if (result > (LONG_MAX - digit) / 10) {
+			return 0;
+		}
+		result = result * 10 + digit;
+		current++;
+	}
+	*cursor = current;
+	*value = result;
+	return 1;
+}
+
+/*
+ * Read the edits of a what-if query, which are separated by spaces or commas. Each edit is the ID of a
+ * process followed by ":service=N" or ":arrival=N", such as "4:service=2".
+ *
+ * query:	the query
+ * edits:	an array of at least MAX_WHAT_IF_EDITS elements where the edits are stored
+ * error:	a buffer of INPUT_ERROR_MAX characters where an error message is written if the query is not valid
+ *
+ * Returns: the number of edits, or -1 if the query is not valid
+ */
+static int parse_what_if_query(const char* query, struct what_if_edit* edits, char* error) {
+	const char* cursor = query;
+	int num_edits = 0;
+	while (1) {
+		while (*cursor == ' ' || *cursor == '\t' || *cursor == ',' || *cursor == '\r' || *cursor == '\n') {
+			cursor++;
+		}
+		if (*cursor == '\0') {
+			break;
+		}
+		if (num_edits == MAX_WHAT_IF_EDITS) {
+			snprintf(error, INPUT_ERROR_MAX, "A query can have at most %d edits!", MAX_WHAT_IF_EDITS);
+			return -1;
+		}
+
+		const char* start = cursor;
+		struct what_if_edit* edit = &edits[num_edits];
+		int valid = scan_query_integer(&cursor, &edit->id) && *cursor++ == ':';
+		if (valid && strncmp(cursor, "service=", 8) == 0) {
+			edit->field = EDIT_SERVICE;
+			cursor += 8;
+		} else if (valid && strncmp(cursor, "arrival=", 8) == 0) {
+			edit->field = EDIT_ARRIVAL;
+			cursor += 8;
+		} else {
+			valid = 0;
+		}
+		valid = valid && scan_query_integer(&cursor, &edit->value) && (*cursor == '\0' || strchr(" \t,\r\n", *cursor) != NULL);
+		if (!valid) {
+			int length = (int) strcspn(start, " \t,\r\n");
+			snprintf(error, INPUT_ERROR_MAX, "\"%.*s\" is not an edit such as \"4:service=2\" or \"4:arrival=10\"!", length, start);
+			return -1;
+		}
+		num_edits++;
+	}
+	if (num_edits == 0) {
+		snprintf(error, INPUT_ERROR_MAX, "The query has no edits!");
+		return -1;
+	}
+	return num_edits;
+}
+
+/*
+ * Move a number of rows of a process table by one row, up or down.
+ *
+ * table:	a pointer to the table
+ * from:	the first row to move
+ * to:		the row the first row is moved to, which is one more or one less than from
+ * count:	the number of rows to move
+ */
+static void shift_rows(struct process_table* table, int from, int to, int count) {
+	memmove(&table->id[to], &table->id[from], count * sizeof(int));
+	memmove(&table->arrival_time[to], &table->arrival_time[from], count * sizeof(long));
+	memmove(&table->service_time[to], &table->service_time[from], count * sizeof(long));
+	memmove(&table->remaining_time[to], &table->remaining_time[from], count * sizeof(long));
+}
+
+/*
+ * Change the arrival time of a process in a process table, moving it to the row that keeps the table sorted
+ * by arrival time. The process goes after the processes that arrive at the same time.
+ *
+ * table:		a pointer to the table
+ * row:			the row of the process
+ * arrival:		the new arrival time of the process
+ *
+ * Returns: the new row of the process
+ */
+static int move_process(struct process_table* table, int row, long arrival) {
+	int id = table->id[row];
+	long service = table->service_time[row];
+	int new_row;
+	if (arrival >= table->arrival_time[row]) {
+		/* Find the first later row that arrives after the new time; the process goes right before it. */
+		int low = row + 1;
+		int high = table->size;
+		while (low < high) {
+			int middle = low + (high - low) / 2;
+			if (table->arrival_time[middle] > arrival) {
+				high = middle;
+			} else {
+				low = middle + 1;
+			}
+		}
+		new_row = low - 1;
+		shift_rows(table, row + 1, row, new_row - row);
+	} else {
+		/* Find the first earlier row that arrives after the new time; the process takes its place. */
+		int low = 0;
+		int high = row;
+		while (low < high) {
+			int middle = low + (high - low) / 2;
+			if (table->arrival_time[middle] > arrival) {
+				high = middle;
+			} else {
+				low = middle + 1;
+			}
+		}
+		new_row = low;
+		shift_rows(table, new_row, new_row + 1, row - new_row);
+	}
+	table->id[new_row] = id;
+	table->arrival_time[new_row] = arrival;
+	table->service_time[new_row] = service;
+	table->remaining_time[new_row] = service;
+	return new_row;
+}
+
+/*
+ * Answer a what-if query: make its edits to the table of the analysis, simulate the edited table from the last
+ * snapshot before the first edited process (or from the start if there is none) until the schedule becomes
+ * the same as the original one again, and add the results of the original simulation from there on. The
+ * table is the same as the original afterwards, so queries do not build on each other.
+ *
+ * what_if:	a pointer to the analysis
+ * query:	the edits, such as "4:service=2 9:arrival=130"
+ * answer:	a pointer to where the answer is stored; the number of events in its results only counts those
+ *			of the re-simulation
+ * error:	a buffer of INPUT_ERROR_MAX characters where an error message is written if the query is not valid
+ *
+ * Returns: 0 on success, -1 if the query is not valid or the re-simulation failed
+ */
+int answer_what_if(struct what_if* what_if, const char* query, struct what_if_answer* answer, char* error) {
+	struct what_if_edit edits[MAX_WHAT_IF_EDITS];
+	int num_edits = parse_what_if_query(query, edits, error);
+	if (num_edits < 0) {
+		return -1;
+	}
+	struct process_table* table = what_if->table;
+	for (int i = 0; i < num_edits; i++) {
+		if (edits[i].id < 1 || edits[i].id > table->size) {
+			snprintf(error, INPUT_ERROR_MAX, "There is no process %ld!", edits[i].id);
+			return -1;
+		}
+	}
+
+	/* Make the edits. Only the rows between the first and the last edited row (both moved ones and the ones
+	 * they passed) differ from the original table, and every other process is still in the row given by its
+	 * ID. */
+	int first_edited_row = table->size;
+	int last_edited_row = -1;
+	long earliest_arrival = LONG_MAX;
+	for (int i = 0; i < num_edits; i++) {
+		int row = (int) edits[i].id - 1;
+		if (row >= first_edited_row && row <= last_edited_row) {
+			for (row = first_edited_row; table->id[row] != edits[i].id; row++) {
+			}
+		}
+		int new_row = row;
+		if (edits[i].field == EDIT_SERVICE) {
+			table->service_time[row] = edits[i].value;
+			table->remaining_time[row] = edits[i].value;
+		} else {
+			new_row = move_process(table, row, edits[i].value);
+			earliest_arrival = edits[i].value < earliest_arrival ? edits[i].value : earliest_arrival;
+		}
+		first_edited_row = row < first_edited_row ? row : first_edited_row;
+		first_edited_row = new_row < first_edited_row ? new_row : first_edited_row;
+		last_edited_row = row > last_edited_row ? row : last_edited_row;
+		last_edited_row = new_row > last_edited_row ? new_row : last_edited_row;
+	}
+
+	/* A snapshot can be resumed from if no edited process had arrived by then and no moved process arrives at
+	 * or before its time. Both the rows and the times of the snapshots only go up, so those that can be
+	 * resumed from come first. */
+	int low = 0;
+	int high = what_if->num_snapshots;
+	while (low < high) {
+		int middle = low + (high - low) / 2;
+		if (what_if->snapshots[middle].next_arrival <= first_edited_row && what_if->snapshots[middle].current_time < earliest_arrival) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	const struct what_if_snapshot* resume = low > 0 ? &what_if->snapshots[low - 1] : NULL;
+
+	/* Re-simulate. MLFQ with priority boosts keeps a clock of its own, which may differ between the schedules
+	 * even where both are idle, so it always runs to the end. */
+	struct arena* run_pool = what_if->run_pool;
+	reset_arena(run_pool);
+	struct output_writer* output = open_output_writer(NULL, OUTPUT_NONE, 0, run_pool);
+	struct arrival_stream arrivals;
+	init_table_stream(&arrivals, table);
+	answer->results.latency = NULL;
+	answer->results.checkpoint = NULL;
+	answer->results.what_if = what_if;
+	what_if->resume = resume;
+	what_if->last_edited_row = last_edited_row;
+	what_if->stop_early = what_if->policy != &mlfq_policy || what_if->params->boost_interval == 0;
+	what_if->stopped_row = -1;
+	what_if->num_resumed = 0;
+	what_if->error = 0;
+	simulate(what_if->policy, what_if->params, &arrivals, output, run_pool, &answer->results);
+	close_output_writer(output);
+	answer->results.what_if = NULL;
+	what_if->resume = NULL;
+
+	/* Put the rows the edits and the re-simulation changed back the way they were. Rows before the first
+	 * process that was alive at the snapshot were not looked at. */
+	int repair_start = resume != NULL ? resume->first_row : 0;
+	int repair_end = what_if->stopped_row >= 0 ? what_if->stopped_row : table->size;
+	repair_end = last_edited_row + 1 > repair_end ? last_edited_row + 1 : repair_end;
+	int repair_count = repair_end - repair_start;
+	memcpy(&table->id[repair_start], &what_if->original->id[repair_start], repair_count * sizeof(int));
+	memcpy(&table->arrival_time[repair_start], &what_if->original->arrival_time[repair_start], repair_count * sizeof(long));
+	memcpy(&table->service_time[repair_start], &what_if->original->service_time[repair_start], repair_count * sizeof(long));
+	memcpy(&table->remaining_time[repair_start], &what_if->original->service_time[repair_start], repair_count * sizeof(long));
+	if (what_if->error) {
+		snprintf(error, INPUT_ERROR_MAX, "Cannot resume from a snapshot!");
+		return -1;
+	}
+
+	/* The processes from the row the re-simulation stopped at on are scheduled as in the original simulation. */
+	answer->resumed_time = resume != NULL ? resume->current_time : -1;
+	answer->stopped_time = what_if->stopped_row >= 0 ? what_if->stopped_time : -1;
+	answer->num_simulated = answer->results.num_processes - what_if->num_resumed;
+	if (what_if->stopped_row >= 0) {
+		int row = what_if->stopped_row;
+		answer->results.num_processes += table->size - row;
+		add_to_sum(&answer->results.sum_turnaround, sum_value(&what_if->suffix_turnaround[row]));
+		add_to_sum(&answer->results.sum_normalized_turnaround, sum_value(&what_if->suffix_normalized_turnaround[row]));
+		add_to_sum(&answer->results.sum_waiting, sum_value(&what_if->suffix_waiting[row]));
+	}
+	return 0;
+}
+
+/*
+ * Deallocate a what-if analysis together with its snapshots.
+ *
+ * what_if:	a pointer to the analysis to be deallocated
+ */
+void destroy_what_if(struct what_if* what_if) {
+	for (int i = 0; i < what_if->num_snapshots; i++) {
+		free(what_if->snapshots[i].state);
+	}
+	destroy_arena(what_if->run_pool);
+	destroy_arena(what_if->pool);
+}
@@ -0,0 +1,142 @@
+/*
+ * Implementation of the Round Robin (RR) scheduling algorithm.
+ *
+ * - Author: Hieu Tran
+ * - Course: COMP 354: Operating Systems
+ * - Instructor: Shikha Mittal
+ * - Date created: 10/17/2026
+ * - Last updated: 10/17/2026
+ */
+
+#include "mydispatcher.h"
+
+/* Representation of the Ready state of RR. */
+struct rr_ready {
+	struct queue* queue;		// the processes in the Ready state, in the order they are dispatched
+	long quantum;				// the time quantum
+};
+
+/*
+ * Create the Ready state of RR, which is a plain queue: processes are added to the end when they arrive or
+ * when their time quantum runs out.
+ *
+ * params:	a pointer to the parameters of the policy, which give the time quantum
+ * pool:	a pointer to the memory pool that owns the Ready state
+ *
+ * Returns: a pointer to the Ready state
+ */
+static void* rr_create(const struct policy_params* params, struct arena* pool) {
+	struct rr_ready* created_ready = (struct rr_ready*) arena_alloc(pool, sizeof(struct rr_ready));
+	created_ready->queue = create_queue(pool);
+	created_ready->quantum = params->quantum;
+	return created_ready;
+}
+
+/*
+ * Add a process that has arrived to the end of the ready queue.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the process is in
+ * process:	the index of the process
+ * now:		the current time
+ */
+static void rr_add_ready(void* ready, const struct process_table* table, int process, long now) {
+	enqueue(((struct rr_ready*) ready)->queue, process);
+}
+
+/*
+ * Get the number of processes in the ready queue.
+ *
+ * ready:	a pointer to the Ready state
+ *
+ * Returns: the number of processes
+ */
+static int rr_num_ready(void* ready) {
+	return ((struct rr_ready*) ready)->queue->size;
+}
+
+/*
+ * Remove the process at the front of the ready queue.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the processes are in
+ * now:		the current time
+ *
+ * Returns: the index of the process to be dispatched
+ */
+static int rr_select_next(void* ready, const struct process_table* table, long now) {
+	return dequeue(((struct rr_ready*) ready)->queue);
+}
+
+/*
+ * Every dispatched process runs for at most one time quantum.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the process is in
+ * process:	the index of the dispatched process
+ *
+ * Returns: the time quantum
+ */
+static long rr_time_slice(void* ready, const struct process_table* table, int process) {
+	return ((struct rr_ready*) ready)->quantum;
+}
+
+/*
+ * Check whether the running process has to be preempted, which is the case when its time quantum has run
+ * out and some other process is ready. Otherwise, it simply gets another time quantum.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the processes are in
+ * running:			the index of the running process
+ * slice_expired:	whether the time quantum of the running process has run out
+ * now:				the current time
+ *
+ * Returns: 1 if the running process has to be preempted, 0 otherwise
+ */
+static int rr_should_preempt(void* ready, const struct process_table* table, int running, int slice_expired, long now) {
+	return slice_expired && rr_num_ready(ready) > 0;
+}
+
+/*
+ * Move a preempted process to the end of the ready queue, behind the processes that arrived while it ran.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the process is in
+ * process:			the index of the preempted process
+ * slice_expired:	whether the time quantum of the process has run out
+ * now:				the current time
+ */
+static void rr_preempt(void* ready, const struct process_table* table, int process, int slice_expired, long now) {
+	rr_add_ready(ready, table, process, now);
+}
+
+/*
+ * Write the ready queue to a checkpoint.
+ *
+ * ready:			a pointer to the Ready state
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ */
+static void rr_save(void* ready, int running, FILE* checkpoint_file) {
+	save_queue(((struct rr_ready*) ready)->queue, checkpoint_file);
+}
+
+/*
+ * Read the Ready state written by rr_save() from a checkpoint into the empty Ready state.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the processes are in
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ *
+ * Returns: 0 on success, -1 if the checkpoint is damaged
+ */
+static int rr_load(void* ready, const struct process_table* table, int running, FILE* checkpoint_file) {
+	return load_queue(((struct rr_ready*) ready)->queue, table, checkpoint_file);
+}
+
+/* The RR scheduling policy. Arrivals never preempt the running process, but the ones that happen while it
+ * runs are added to the ready queue before it when its time quantum runs out. */
+const struct policy rr_policy = {
+	"RR", 0, rr_create, rr_add_ready, rr_num_ready, rr_select_next, rr_time_slice, rr_should_preempt, rr_preempt, rr_save, rr_load, NULL
+};
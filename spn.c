@@ -5,98 +5,127 @@
  * - Course: COMP 354: Operating Systems
  * - Instructor: Shikha Mittal
  * - Date created: 05/15/2020
- * - Last updated: 05/28/2020
+ * - Last updated: 10/17/2026
  */
 
 #include "mydispatcher.h"
 
+/* Representation of the Ready state of SPN. */
+struct spn_ready {
+	struct heap* queue;			// the ready queue, ordered by service time (or by aged service time)
+	long aging_interval;		// how long a process waits to count as one unit shorter (0 for never)
+};
+
 /*
- * Produce the results of the SPN scheduling policy for a specified list of processes.
+ * Create the Ready state of SPN, which is a priority queue ordered by service time. Since remaining time is
+ * never updated before a process is dispatched under SPN, it is always equal to service time and is used as
+ * the key instead. Processes with the same service time are dispatched in order of arrival. With aging, the
+ * queue is ordered by the keys of aged_key() instead, so that long processes are not starved.
+ *
+ * params:	a pointer to the parameters of the policy
+ * pool:	a pointer to the memory pool that owns the priority queue
  *
- * process_list:	a pointer to the list of processes to be scheduled
- * output_file:		a pointer to the file to write output to
+ * Returns: a pointer to the Ready state
  */
-void spn(struct queue* process_list, FILE* output_file) {
-	int num_process = process_list->size;						  	// hold the total number of processes
-
-	/* Continue only if the list of processes is not empty. */
-	if (process_list->head != NULL) {
-		/* Hold the total turnaround time, normalized turnaround time and waiting time of all processes to
-		 * calculate the averages after all processes have been scheduled. */
-		double sum_turnaround = 0;
-		double sum_normalized_turnaround = 0;
-		double sum_waiting = 0;
-
-		/* Create a queue for processes in the Ready state. Initialize the current time to be the arrival time
-		 * of the first process in the list, which should be the earliest arriving process. Create a pointer
-		 * for a process in the Running state. Create a variable to hold the time a process is dispatched. */
-		struct queue* ready_queue = create_queue();
-		int current_time = process_list->head->data->arrival_time;
-		struct process* running_process = NULL;
-		int start_time;
-
-		while (1) {
-			if (running_process == NULL) {
-				/* If there is no running process: */
-
-				if (process_list->head != NULL && process_list->head->data->arrival_time <= current_time) {
-					/* First, add all processes with arrival time less than or equal to the current time to
-					 * the ready queue and remove such processes from the list. Technically, a process with
-					 * arrival time less than the current time should have already arrived. However, since SPN
-					 * is non-preemptive, it makes no difference to the results of this scheduling algorithm.
-					 * Additionally, since remaining time is never updated throughout this algorithm, it is
-					 * always equal to service time and can be used for sorting instead of service time. */
-					enqueue_with_sorting(ready_queue, dequeue(process_list));
+static void* spn_create(const struct policy_params* params, struct arena* pool) {
+	struct spn_ready* created_ready = (struct spn_ready*) arena_alloc(pool, sizeof(struct spn_ready));
+	created_ready->queue = create_heap(pool);
+	created_ready->aging_interval = params->aging_interval;
+	return created_ready;
+}
 
-				} else if (ready_queue->head != NULL) {
-					/* If there is no process to be added and the ready queue is not empty, dispatch the first
-					 * (frontmost) process in the ready queue. Store the current time as the time this process
-					 * is dispatched. */
-					running_process = dequeue(ready_queue);
-					start_time = current_time;
+/*
+ * Add a process that has arrived to the ready queue. The process is only moved into place when the queue is
+ * next looked at, so that a batch of processes arriving at the same time is added at once. A process may be
+ * added some time after it arrived, while another process ran, so it ages from its arrival time.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the process is in
+ * process:	the index of the process
+ * now:		the current time
+ */
+static void spn_add_ready(void* ready, const struct process_table* table, int process, long now) {
+	struct spn_ready* current_ready = (struct spn_ready*) ready;
+	heap_append(current_ready->queue, process, aged_key(table->remaining_time[process], table->arrival_time[process], current_ready->aging_interval));
+}
 
-				} else if (process_list->head != NULL) {
-					/* If the ready queue is empty but there still exists some process in the list (that is
-					 * not yet scheduled), set the current time to the arrival time of the first process in
-					 * the list, since nothing can happen until that time. */
-					current_time = process_list->head->data->arrival_time;
+/*
+ * Get the number of processes in the ready queue.
+ *
+ * ready:	a pointer to the Ready state
+ *
+ * Returns: the number of processes
+ */
+static int spn_num_ready(void* ready) {
+	return ((struct spn_ready*) ready)->queue->size;
+}
 
-				} else {
-					/* If the list is also empty, then all processes have been scheduled. */
-					break;
-				}
-			} else {
-				/* If there is a running process, skip to the time it completes its execution. Technically,
-				 * other processes can arrive while this process is running, but since SPN is non-preemptive,
-				 * adding them to the ready queue after the process finishes makes no difference to the results
-				 * of this scheduling algorithm as long as the ready queue remains sorted at all times. */
-				current_time += running_process->service_time;
+/*
+ * Remove the process with the shortest service time (or aged service time) from the ready queue.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the processes are in
+ * now:		the current time
+ *
+ * Returns: the index of the process to be dispatched
+ */
+static int spn_select_next(void* ready, const struct process_table* table, long now) {
+	return heap_extract_min(((struct spn_ready*) ready)->queue);
+}
 
-				/* Calculate the turnaround time and waiting time of the completed process, then write the
-				 * needed information to the output file. */
-				int turnaround_time = current_time - running_process->arrival_time;
-				int waiting_time = turnaround_time - running_process->service_time;
-				fprintf(output_file, "%d runs %d-%d: A=%d, S=%d, W=%d, F=%d, T=%d\n", running_process->id, start_time, current_time, running_process->arrival_time, running_process->service_time, waiting_time, current_time, turnaround_time);
+/*
+ * SPN lets a dispatched process run until it completes, so its time slice is unlimited.
+ *
+ * Returns: 0
+ */
+static long spn_time_slice(void* ready, const struct process_table* table, int process) {
+	return 0;
+}
 
-				/* Add the turnaround time, normalized turnaround time and waiting time to the total to
-				 * calculate the averages later. */
-				sum_turnaround += turnaround_time;
-				sum_normalized_turnaround += ((double) turnaround_time) / running_process->service_time;
-				sum_waiting += waiting_time;
+/*
+ * SPN is non-preemptive, so the running process is never preempted.
+ *
+ * Returns: 0
+ */
+static int spn_should_preempt(void* ready, const struct process_table* table, int running, int slice_expired, long now) {
+	return 0;
+}
 
-				/* Deallocate unneeded memory and set the running process to NULL. */
-				free(running_process);
-				running_process = NULL;
-			}
-		}
+/*
+ * Never called, since SPN never preempts the running process.
+ */
+static void spn_preempt(void* ready, const struct process_table* table, int process, int slice_expired, long now) {
+	spn_add_ready(ready, table, process, now);
+}
 
-		/* Calculate and print out the average turnaround time, average normalized turnaround time and average
-		 * waiting time across all processes. */
-		printf("Average turnaround time = %f\n", sum_turnaround/num_process);
-		printf("Average normalized turnaround time = %f\n", sum_normalized_turnaround/num_process);
-		printf("Average waiting time = %f\n", sum_waiting/num_process);
+/*
+ * Write the ready queue to a checkpoint.
+ *
+ * ready:			a pointer to the Ready state
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ */
+static void spn_save(void* ready, int running, FILE* checkpoint_file) {
+	save_heap(((struct spn_ready*) ready)->queue, checkpoint_file);
+}
 
-		/* Deallocate unneeded memory. */
-		free(ready_queue);
-	}
+/*
+ * Read the ready queue written by spn_save() from a checkpoint into the empty ready queue.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the processes are in
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ *
+ * Returns: 0 on success, -1 if the checkpoint is damaged
+ */
+static int spn_load(void* ready, const struct process_table* table, int running, FILE* checkpoint_file) {
+	return load_heap(((struct spn_ready*) ready)->queue, table, checkpoint_file);
 }
+
+/* The SPN scheduling policy. Since it is non-preemptive, the clock may skip past arrivals while a process
+ * runs: the arrived processes are added to the ready queue as soon as the running process completes, which
+ * makes no difference to the results since they are still added in order of arrival. */
+const struct policy spn_policy = {
+	"SPN", 0, spn_create, spn_add_ready, spn_num_ready, spn_select_next, spn_time_slice, spn_should_preempt, spn_preempt, spn_save, spn_load, NULL
+};
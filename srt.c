@@ -5,128 +5,182 @@
  * - Course: COMP 354: Operating Systems
  * - Instructor: Shikha Mittal
  * - Date created: 05/15/2020
- * - Last updated: 05/28/2020
+ * - Last updated: 10/17/2026
  */
 
 #include "mydispatcher.h"
 
+/* Representation of the Ready state of SRT. */
+struct srt_ready {
+	struct heap* queue;			// the ready queue, ordered by remaining time (or by aged remaining time)
+	long aging_interval;		// how long a process waits to count as one unit shorter (0 for never)
+};
+
 /*
- * Produce the results of the SRT scheduling policy for a specified list of processes.
+ * Create the Ready state of SRT, which is a priority queue ordered by remaining time. Processes with the same
+ * remaining time are dispatched in the order they were added to the queue. With aging, the queue is ordered
+ * by the keys of aged_key() instead, so that long processes are not starved.
+ *
+ * params:	a pointer to the parameters of the policy
+ * pool:	a pointer to the memory pool that owns the priority queue
  *
- * process_list:	a pointer to the list of processes to be scheduled
- * output_file:		a pointer to the file to write output to
+ * Returns: a pointer to the Ready state
  */
-void srt(struct queue* process_list, FILE* output_file) {
-	int num_process = process_list->size;						  	// hold the total number of processes
-
-	/* Continue only if the list of processes is not empty. */
-	if (process_list->head != NULL) {
-		/* Hold the total turnaround time, normalized turnaround time and waiting time of all processes to
-		 * calculate the averages after all processes have been scheduled. */
-		double sum_turnaround = 0;
-		double sum_normalized_turnaround = 0;
-		double sum_waiting = 0;
-
-		/* Create a queue for processes in the Ready state. Initialize the current time to be the arrival time
-		 * of the first process in the list, which should be the earliest arriving process. Create a pointer
-		 * for a process in the Running state. Create a variable to hold the time a process is dispatched. */
-		struct queue* ready_queue = create_queue();
-		int current_time = process_list->head->data->arrival_time;
-		struct process* running_process = NULL;
-		int start_time;
-
-		while (1) {
-			if (process_list->head != NULL && process_list->head->data->arrival_time == current_time) {
-				/* First, add all processes with arrival time equal to the current time to the ready queue
-				 * and remove such processes from the list. */
-				enqueue_with_sorting(ready_queue, dequeue(process_list));
-
-			} else if (running_process == NULL) {
-				/* If there is no running process and no process to be added: */
-
-				if (ready_queue->head != NULL) {
-					/* If the ready queue is not empty, dispatch the first (frontmost) process in the ready
-					 * queue. Store the current time as the time this process is dispatched. */
-					running_process = dequeue(ready_queue);
-					start_time = current_time;
-
-				} else if (process_list->head != NULL) {
-					/* If the ready queue is empty but there still exists some process in the list (that is
-					 * not yet scheduled), set the current time to the arrival time of the first process in
-					 * the list, since nothing can happen until that time. */
-					current_time = process_list->head->data->arrival_time;
-
-				} else {
-					/* If the list is also empty, then all processes have been scheduled. */
-					break;
-				}
-			} else {
-				/* If there is a running process and no process to be added: */
-
-				if (running_process->remaining_time == 0) {
-					/* If the remaining time of the running process is 0, it completes its execution at this
-					 * time. */
+static void* srt_create(const struct policy_params* params, struct arena* pool) {
+	struct srt_ready* created_ready = (struct srt_ready*) arena_alloc(pool, sizeof(struct srt_ready));
+	created_ready->queue = create_heap(pool);
+	created_ready->aging_interval = params->aging_interval;
+	return created_ready;
+}
 
-					/* Calculate the turnaround time and waiting time of the completed process, then write
-					 * the needed information to the output file. */
-					int turnaround_time = current_time - running_process->arrival_time;
-					int waiting_time = turnaround_time - running_process->service_time;
-					fprintf(output_file, "%d runs %d-%d: A=%d, S=%d, W=%d, F=%d, T=%d\n", running_process->id, start_time, current_time, running_process->arrival_time, running_process->service_time, waiting_time, current_time, turnaround_time);
+/*
+ * Work out the key of a process, which is its remaining time, or with aging its remaining time less one time unit
+ * for every aging_interval time units it has waited since it arrived. Since the process has waited for as long as
+ * it has been in the system without running, that is the same key as if it had been ready since its arrival time
+ * plus the time it has run, and that key never changes while it waits and never goes up while it runs.
+ *
+ * current_ready:	a pointer to the Ready state
+ * table:			a pointer to the table the process is in
+ * process:			the index of the process
+ *
+ * Returns: the key
+ */
+static long srt_key(const struct srt_ready* current_ready, const struct process_table* table, int process) {
+	long remaining = table->remaining_time[process];
+	return aged_key(remaining, table->arrival_time[process] + table->service_time[process] - remaining, current_ready->aging_interval);
+}
 
-					/* Add the turnaround time, normalized turnaround time and waiting time to the total to
-					 * calculate the averages later. */
-					sum_turnaround += turnaround_time;
-					sum_normalized_turnaround += ((double) turnaround_time) / running_process->service_time;
-					sum_waiting += waiting_time;
+/*
+ * Add a process to the ready queue, keyed on its remaining time (or aged remaining time). This is used both for
+ * processes that have just arrived and for processes that have been preempted. The process is only moved into
+ * place when the queue is next looked at, so that a batch of processes arriving at the same time is added at once.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the process is in
+ * process:	the index of the process
+ * now:		the current time
+ */
+static void srt_add_ready(void* ready, const struct process_table* table, int process, long now) {
+	struct srt_ready* current_ready = (struct srt_ready*) ready;
+	heap_append(current_ready->queue, process, srt_key(current_ready, table, process));
+}
 
-					/* Deallocate unneeded memory and set the running process to NULL. */
-					free(running_process);
-					running_process = NULL;
+/*
+ * Get the number of processes in the ready queue.
+ *
+ * ready:	a pointer to the Ready state
+ *
+ * Returns: the number of processes
+ */
+static int srt_num_ready(void* ready) {
+	return ((struct srt_ready*) ready)->queue->size;
+}
 
-				} else if (ready_queue->head != NULL && ready_queue->head->data->remaining_time < running_process->remaining_time) {
-					/* If the running process is not yet finished and its remaining time is longer than that
-					 * of the first (frontmost) process in the ready queue, move the running process back to
-					 * the ready queue after writing the needed information to the output file. Then,
-					 * dispatch the first process in the ready queue and store the current time as the time
-					 * this process is dispatched. */
-					fprintf(output_file, "%d runs %d-%d\n", running_process->id, start_time, current_time);
-					enqueue_with_sorting(ready_queue, running_process);
-					running_process = dequeue(ready_queue);
-					start_time = current_time;
+/*
+ * Remove the process with the shortest remaining time (or aged remaining time) from the ready queue.
+ *
+ * ready:	a pointer to the Ready state
+ * table:	a pointer to the table the processes are in
+ * now:		the current time
+ *
+ * Returns: the index of the process to be dispatched
+ */
+static int srt_select_next(void* ready, const struct process_table* table, long now) {
+	return heap_extract_min(((struct srt_ready*) ready)->queue);
+}
 
-				} else if (process_list->head != NULL && process_list->head->data->arrival_time - current_time <= running_process->remaining_time) {
-					/* If there is no process in the ready queue with a shorter remaining time than the
-					 * running process, check if there is any process arriving between the current time and
-					 * the time the running process finishes. If there is, skip to the time that process
-					 * arrives, after updating the remaining time of the running process.
-					 */
-					int next_arrival_time = process_list->head->data->arrival_time;
-					running_process->remaining_time -= next_arrival_time - current_time;
-					current_time = next_arrival_time;
+/*
+ * SRT has no time slices, since it only preempts the running process when a shorter process arrives.
+ *
+ * Returns: 0
+ */
+static long srt_time_slice(void* ready, const struct process_table* table, int process) {
+	return 0;
+}
 
-					/* What happens right after this is that that process arrives and gets added to the ready
-					 * queue, then the condition is checked again to see if the running process has to be
-					 * moved back to the ready queue. */
+/*
+ * Check whether the running process has to be preempted, which is the case if its remaining time is longer
+ * than that of the shortest process in the ready queue. With aging, the aged remaining times are compared. The
+ * key of the running process can only go down while it runs, so a process that does not preempt it on arrival
+ * never would later.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the processes are in
+ * running:			the index of the running process
+ * slice_expired:	whether the time slice of the running process has ended (never the case for SRT)
+ * now:				the current time
+ *
+ * Returns: 1 if the running process has to be preempted, 0 otherwise
+ */
+static int srt_should_preempt(void* ready, const struct process_table* table, int running, int slice_expired, long now) {
+	struct srt_ready* current_ready = (struct srt_ready*) ready;
+	return current_ready->queue->size > 0 && heap_peek_key(current_ready->queue) < srt_key(current_ready, table, running);
+}
 
-				} else {
-					/* If there is no process arriving between the current time and the time the running
-					 * process finishes, skip to the time the running process finishes and change its
-					 * remaining time to 0. */
-					current_time += running_process->remaining_time;
-					running_process->remaining_time = 0;
+/*
+ * Move a preempted process back to the ready queue. It goes behind the processes with the same remaining time
+ * that are already in the queue.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the process is in
+ * process:			the index of the preempted process
+ * slice_expired:	whether the time slice of the process has ended (never the case for SRT)
+ * now:				the current time
+ */
+static void srt_preempt(void* ready, const struct process_table* table, int process, int slice_expired, long now) {
+	srt_add_ready(ready, table, process, now);
+}
 
-					/* What happens right after this is that the running process completes its execution. */
-				}
-			}
-		}
+/*
+ * Write the ready queue to a checkpoint.
+ *
+ * ready:			a pointer to the Ready state
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ */
+static void srt_save(void* ready, int running, FILE* checkpoint_file) {
+	save_heap(((struct srt_ready*) ready)->queue, checkpoint_file);
+}
 
-		/* Calculate and print out the average turnaround time, average normalized turnaround time and average
-		 * waiting time across all processes. */
-		printf("Average turnaround time = %f\n", sum_turnaround/num_process);
-		printf("Average normalized turnaround time = %f\n", sum_normalized_turnaround/num_process);
-		printf("Average waiting time = %f\n", sum_waiting/num_process);
+/*
+ * Read the ready queue written by srt_save() from a checkpoint into the empty ready queue.
+ *
+ * ready:			a pointer to the Ready state
+ * table:			a pointer to the table the processes are in
+ * running:			the index of the running process (unused)
+ * checkpoint_file:	the checkpoint file
+ *
+ * Returns: 0 on success, -1 if the checkpoint is damaged
+ */
+static int srt_load(void* ready, const struct process_table* table, int running, FILE* checkpoint_file) {
+	return load_heap(((struct srt_ready*) ready)->queue, table, checkpoint_file);
+}
 
-		/* Deallocate unneeded memory. */
-		free(ready_queue);
+/*
+ * Work out a key of a running process that does not change while it runs. Its key from srt_key() goes down by
+ * the same amount for every time unit any process runs (1 without aging, aging_interval - 1 with it), so adding
+ * that amount for every time unit up to now gives the same order among running processes at any time: the
+ * process with the largest key has the longest (aged) remaining time.
+ *
+ * ready:		a pointer to the Ready state
+ * table:		a pointer to the table the process is in
+ * running:		the index of the running process, whose remaining time is up to date
+ * now:			the current time
+ *
+ * Returns: the key, clamped to LONG_MAX
+ */
+static long srt_running_key(void* ready, const struct process_table* table, int running, long now) {
+	struct srt_ready* current_ready = (struct srt_ready*) ready;
+	long key = srt_key(current_ready, table, running);
+	long rate = current_ready->aging_interval > 0 ? current_ready->aging_interval - 1 : 1;
+	if (rate > 0 && now > (LONG_MAX - key) / rate) {
+		return LONG_MAX;
 	}
+	return key + rate * now;
 }
+
+/* The SRT scheduling policy. The clock stops at every arrival while a process runs, so that the arrived
+ * process can be compared with the running one. */
+const struct policy srt_policy = {
+	"SRT", 1, srt_create, srt_add_ready, srt_num_ready, srt_select_next, srt_time_slice, srt_should_preempt, srt_preempt, srt_save, srt_load, srt_running_key
+};